@@ -0,0 +1,82 @@
+/*
+ * bench_common.h
+ *
+ * Helpers shared by the miniconf benchmarks and tests: the best time of repeated
+ * runs, and heap statistics of a replaced global operator new. The operators are
+ * only replaced if MINICONF_BENCH_COUNT_ALLOCATIONS is defined before the header
+ * is included, by the single source file of a program.
+ */
+
+#ifndef __MINICONF_BENCH_COMMON_H__
+#define __MINICONF_BENCH_COMMON_H__
+
+#include <chrono>
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+
+namespace miniconf
+{
+    namespace bench
+    {
+        // Number of runs, the best run is reported
+        static const int RUN_COUNT = 5;
+
+        // Runs a benchmark several times and returns the best time in milliseconds
+        template <typename Func>
+        inline double bestOf(Func func)
+        {
+            typedef std::chrono::steady_clock Clock;
+            double best = 0.0;
+            for (int r = 0; r < RUN_COUNT; ++r) {
+                Clock::time_point start = Clock::now();
+                func();
+                double elapsed = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+                best = (r == 0 || elapsed < best) ? elapsed : best;
+            }
+            return best;
+        }
+
+#ifdef MINICONF_BENCH_COUNT_ALLOCATIONS
+        // Number of allocations by the global operator new
+        static size_t allocationCount = 0;
+
+        // Number of bytes currently allocated by the global operator new
+        static size_t liveBytes = 0;
+
+        // Size header in front of each block, it keeps the alignment of the block
+        static const size_t HEADER_SIZE = alignof(std::max_align_t);
+#endif
+    }
+}
+
+#ifdef MINICONF_BENCH_COUNT_ALLOCATIONS
+void* operator new(size_t size)
+{
+    char* block = static_cast<char*>(malloc(size + miniconf::bench::HEADER_SIZE));
+    if (!block) {
+        throw std::bad_alloc();
+    }
+    *reinterpret_cast<size_t*>(block) = size;
+    ++miniconf::bench::allocationCount;
+    miniconf::bench::liveBytes += size;
+    return block + miniconf::bench::HEADER_SIZE;
+}
+
+void operator delete(void* p) noexcept
+{
+    if (p) {
+        char* block = static_cast<char*>(p) - miniconf::bench::HEADER_SIZE;
+        miniconf::bench::liveBytes -= *reinterpret_cast<size_t*>(block);
+        free(block);
+    }
+}
+
+// The size is read from the header of the block, as for the unsized operator
+void operator delete(void* p, size_t) noexcept
+{
+    operator delete(p);
+}
+#endif
+
+#endif // __MINICONF_BENCH_COMMON_H__
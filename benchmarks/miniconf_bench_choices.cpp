@@ -0,0 +1,82 @@
+/*
+ * miniconf benchmark: choice options
+ *
+ * Measures the time to dispatch on the value of an option with 8 allowed
+ * values: comparing the string value of a STRING option with a strcmp chain,
+ * and switching on the code of a CHOICE option. The time to resolve a name to
+ * its code with the perfect hash of Config::Choices is reported as well.
+ */
+
+#include <cstdio>
+#include <cstring>
+#include <miniconf.h>
+#include "bench_common.h"
+
+using miniconf::bench::RUN_COUNT;
+using miniconf::bench::bestOf;
+
+// Number of dispatches of each benchmark
+static const int DISPATCH_COUNT = 10000000;
+
+// Allowed values, the last ones are the slowest in a strcmp chain
+static const char* NAMES[] = {"none", "fast", "balanced", "safe", "paranoid", "debug", "trace", "off"};
+
+// Number of allowed values
+static const int NAME_COUNT = sizeof(NAMES) / sizeof(NAMES[0]);
+
+// Dispatches on a name with a strcmp chain, as applications emulate enums
+static int dispatchByName(const char* name)
+{
+    for (int i = 0; i < NAME_COUNT; ++i) {
+        if (strcmp(name, NAMES[i]) == 0) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+/* Main file */
+int main()
+{
+    std::vector<std::string> names(NAMES, NAMES + NAME_COUNT);
+    std::vector<miniconf::Value> strings;
+    std::vector<miniconf::Value> choices;
+    miniconf::Config::Choices allowed(names);
+    for (int i = 0; i < NAME_COUNT; ++i) {
+        strings.emplace_back(NAMES[i]);
+        choices.push_back(allowed.value(i));
+    }
+
+    long long total = 0;
+    double byName = bestOf([&]() {
+        for (int i = 0; i < DISPATCH_COUNT; ++i) {
+            total += dispatchByName(strings[i % NAME_COUNT].getString().c_str());
+        }
+    });
+    double byCode = bestOf([&]() {
+        for (int i = 0; i < DISPATCH_COUNT; ++i) {
+            switch (choices[i % NAME_COUNT].getChoice()) {
+                case 0: total += 0; break;
+                case 1: total += 1; break;
+                case 2: total += 2; break;
+                case 3: total += 3; break;
+                case 4: total += 4; break;
+                case 5: total += 5; break;
+                case 6: total += 6; break;
+                default: total += 7; break;
+            }
+        }
+    });
+    double resolving = bestOf([&]() {
+        for (int i = 0; i < DISPATCH_COUNT; ++i) {
+            const std::string& name = names[i % NAME_COUNT];
+            total += allowed.find(name.c_str(), name.size());
+        }
+    });
+
+    printf("Dispatching on %d allowed values (best of %d runs)\n", NAME_COUNT, RUN_COUNT);
+    printf("    STRING value, strcmp chain  : %10.3f ns per dispatch\n", byName * 1e6 / DISPATCH_COUNT);
+    printf("    CHOICE value, switch        : %10.3f ns per dispatch\n", byCode * 1e6 / DISPATCH_COUNT);
+    printf("    Choices::find()             : %10.3f ns per name\n", resolving * 1e6 / DISPATCH_COUNT);
+    return (total < 0) ? 1 : 0;
+}
@@ -0,0 +1,87 @@
+/*
+ * miniconf benchmark: typed value columns
+ *
+ * Defines 100000 options of mixed types, and measures bulk operations over
+ * all values: summing the numeric values via Config::values() and via the
+ * columns of a ValueColumns snapshot, as well as taking, hashing and
+ * comparing snapshots.
+ */
+
+#include <cstdio>
+#include <miniconf.h>
+#include "bench_common.h"
+
+using miniconf::bench::RUN_COUNT;
+using miniconf::bench::bestOf;
+
+// Number of options
+static const int OPTION_COUNT = 100000;
+
+/* Main file */
+int main()
+{
+    miniconf::Config conf;
+    conf.log(miniconf::Config::LogLevel::NONE);
+    for (int i = 0; i < OPTION_COUNT; ++i) {
+        char flag[64];
+        snprintf(flag, sizeof(flag), "params.group%02d.param%06d", i % 100, i);
+        miniconf::Config::Option& o = conf.option(flag).description("A parameter");
+        switch (i % 4) {
+            case 0: o.defaultValue(i); break;
+            case 1: o.defaultValue(i * 0.5); break;
+            case 2: o.defaultValue(i % 3 == 0); break;
+            default: o.defaultValue("value"); break;
+        }
+    }
+
+    double sum = 0.0;
+    double byValues = bestOf([&]() {
+        std::map<std::string, const miniconf::Value*> values;
+        conf.values(values);
+        for (auto && v : values) {
+            switch (v.second->type()) {
+                case miniconf::Value::DataType::INT: sum += v.second->getInt(); break;
+                case miniconf::Value::DataType::NUMBER: sum += v.second->getNumber(); break;
+                default: break;
+            }
+        }
+    });
+
+    std::shared_ptr<const miniconf::Config::ValueColumns> columns;
+    double snapshot = bestOf([&]() {
+        columns = conf.valueColumns();
+    });
+    double byColumns = bestOf([&]() {
+        miniconf::Config::ValueColumns::Column<int64_t> ints = columns->ints();
+        miniconf::Config::ValueColumns::Column<double> numbers = columns->numbers();
+        int64_t intSum = 0;
+        for (size_t i = 0; i < ints.size; ++i) {
+            intSum += ints.values[i];
+        }
+        double numberSum = 0.0;
+        for (size_t i = 0; i < numbers.size; ++i) {
+            numberSum += numbers.values[i];
+        }
+        sum += static_cast<double>(intSum) + numberSum;
+    });
+
+    uint64_t hash = 0;
+    double hashing = bestOf([&]() {
+        hash ^= columns->hash();
+    });
+    conf["params.group01.param000001"] = 2.5;
+    std::shared_ptr<const miniconf::Config::ValueColumns> modified = conf.valueColumns();
+    std::vector<uint32_t> changed;
+    double diffing = bestOf([&]() {
+        changed.clear();
+        columns->diff(*modified, changed);
+    });
+
+    printf("Bulk operations over %d options (best of %d runs)\n", OPTION_COUNT, RUN_COUNT);
+    printf("    Config::values() sum       : %10.3f ms\n", byValues);
+    printf("    ValueColumns sum           : %10.3f ms\n", byColumns);
+    printf("    Config::valueColumns()     : %10.3f ms\n", snapshot);
+    printf("    ValueColumns::hash()       : %10.3f ms\n", hashing);
+    printf("    ValueColumns::diff()       : %10.3f ms (%zu changed)\n", diffing, changed.size());
+    return (sum < 0 || hash == 1) ? 1 : 0;
+}
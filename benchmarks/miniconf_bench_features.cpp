@@ -0,0 +1,73 @@
+/*
+ * miniconf benchmark: feature flags
+ *
+ * Defines 100000 boolean feature flags and measures the time to check a flag
+ * by its name via Config::value() and by its ID in a FeatureFlags snapshot,
+ * as well as the time to take a snapshot and the size of its bit set.
+ */
+
+#include <cstdio>
+#include <miniconf.h>
+#include "bench_common.h"
+
+using miniconf::bench::RUN_COUNT;
+using miniconf::bench::bestOf;
+
+// Number of feature flags
+static const int FLAG_COUNT = 100000;
+
+// Number of checks of each benchmark
+static const int CHECK_COUNT = 10000000;
+
+/* Main file */
+int main()
+{
+    miniconf::Config conf;
+    std::vector<std::string> flags;
+    for (int i = 0; i < FLAG_COUNT; ++i) {
+        char flag[64];
+        snprintf(flag, sizeof(flag), "features.group%02d.flag%06d", i % 100, i);
+        flags.emplace_back(flag);
+        conf.option(flags.back()).defaultValue(i % 3 == 0).description("Enables an experimental feature");
+    }
+
+    // pseudo random flags, so that the checks are not served by one cache line
+    std::vector<uint32_t> order(CHECK_COUNT / 100);
+    uint32_t state = 12345;
+    for (auto && o : order) {
+        state = state * 1664525u + 1013904223u;
+        o = state % FLAG_COUNT;
+    }
+
+    std::shared_ptr<const miniconf::Config::FeatureFlags> snapshot;
+    double snapshotTime = bestOf([&]() {
+        snapshot = conf.featureFlags();
+    });
+    std::vector<uint32_t> ids(FLAG_COUNT);
+    for (int i = 0; i < FLAG_COUNT; ++i) {
+        ids[i] = snapshot->id(flags[i]);
+    }
+
+    size_t enabled = 0;
+    double byName = bestOf([&]() {
+        for (int i = 0; i < CHECK_COUNT / 100; ++i) {
+            enabled += conf.value(flags[order[i]]).getBoolean() ? 1 : 0;
+        }
+    }) * 100;
+    miniconf::Config::FeatureStore store(snapshot);
+    double byId = bestOf([&]() {
+        std::shared_ptr<const miniconf::Config::FeatureFlags> current = store.load();
+        for (int r = 0; r < 100; ++r) {
+            for (int i = 0; i < CHECK_COUNT / 100; ++i) {
+                enabled += current->isEnabled(ids[order[i]]) ? 1 : 0;
+            }
+        }
+    });
+
+    printf("Checking %d feature flags (best of %d runs)\n", FLAG_COUNT, RUN_COUNT);
+    printf("    Config::value()           : %10.3f ns per check\n", byName * 1e6 / CHECK_COUNT);
+    printf("    FeatureFlags::isEnabled() : %10.3f ns per check\n", byId * 1e6 / CHECK_COUNT);
+    printf("    Config::featureFlags()    : %10.3f ms per snapshot\n", snapshotTime);
+    printf("    Bit set                   : %10zu bytes (%zu enabled checks)\n", (snapshot->size() + 7) / 8, enabled);
+    return 0;
+}
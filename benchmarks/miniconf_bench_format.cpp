@@ -0,0 +1,76 @@
+/* 
+ * miniconf benchmark: number formatting
+ *
+ * Measures the time to format a large number of doubles with printf("%f"),
+ * printf("%.17g") and miniconf::formatNumber(), and counts the numbers which
+ * do not parse back to the same value.
+ */
+
+#include <cstdio>
+#include <random>
+#include <miniconf.h>
+#include "bench_common.h"
+
+using miniconf::bench::RUN_COUNT;
+using miniconf::bench::bestOf;
+
+// Number of doubles to be formatted
+static const int NUMBER_COUNT = 2000000;
+
+// Formats all the numbers, returns the number of values which do not round-trip
+template <typename Format>
+static int formatAll(const std::vector<double>& numbers, Format format, bool verify)
+{
+    char buffer[64];
+    int mismatches = 0;
+    for (double n : numbers) {
+        format(n, buffer);
+        if (verify && strtod(buffer, nullptr) != n) {
+            ++mismatches;
+        }
+    }
+    return mismatches;
+}
+
+// Formats the numbers with each formatter and prints the results
+static void run(const char* name, const std::vector<double>& numbers)
+{
+    auto fixed = [](double n, char* buffer) { snprintf(buffer, 64, "%f", n); };
+    auto exact = [](double n, char* buffer) { snprintf(buffer, 64, "%.17g", n); };
+    auto shortest = [](double n, char* buffer) { miniconf::formatNumber(n, buffer); };
+
+    printf("Formatting %d %s (best of %d runs)\n", NUMBER_COUNT, name, RUN_COUNT);
+    printf("    printf(\"%%f\")             : %10.3f ms, %7d values do not round-trip\n", 
+        bestOf([&]() { formatAll(numbers, fixed, false); }), formatAll(numbers, fixed, true));
+    printf("    printf(\"%%.17g\")          : %10.3f ms, %7d values do not round-trip\n", 
+        bestOf([&]() { formatAll(numbers, exact, false); }), formatAll(numbers, exact, true));
+    printf("    miniconf::formatNumber() : %10.3f ms, %7d values do not round-trip\n", 
+        bestOf([&]() { formatAll(numbers, shortest, false); }), formatAll(numbers, shortest, true));
+}
+
+/* Main file */
+int main()
+{
+    std::mt19937_64 generator(42);
+
+    // decimal numbers with a few digits, as usually found in config files
+    std::vector<double> decimals(NUMBER_COUNT);
+    std::uniform_int_distribution<int> mantissa(1, 999999);
+    std::uniform_int_distribution<int> exponent(0, 9);
+    for (auto && n : decimals) {
+        n = mantissa(generator) / pow(10.0, exponent(generator));
+    }
+
+    // arbitrary finite doubles
+    std::vector<double> arbitrary(NUMBER_COUNT);
+    for (auto && n : arbitrary) {
+        do {
+            uint64_t bits = generator();
+            memcpy(&n, &bits, sizeof(n));
+        } while (std::isnan(n) || std::isinf(n));
+    }
+
+    run("decimal numbers", decimals);
+    run("arbitrary doubles", arbitrary);
+    return 0;
+}
@@ -0,0 +1,87 @@
+/* 
+ * miniconf benchmark: JSON loading
+ *
+ * Measures the time, the number of allocations and the memory used to parse
+ * a large nested JSON config file, and the time to load it into a Config. 
+ * The benchmark is built twice, with std::map objects ("miniconf_bench_json")
+ * and with flat objects ("miniconf_bench_json_flat", MINICONF_JSON_FLAT_OBJECT).
+ */
+
+#include <cstdio>
+#include <miniconf.h>
+#define MINICONF_BENCH_COUNT_ALLOCATIONS
+#include "bench_common.h"
+
+using miniconf::bench::RUN_COUNT;
+using miniconf::bench::bestOf;
+using miniconf::bench::liveBytes;
+using miniconf::bench::allocationCount;
+
+// Number of sections, services and keys of the generated config
+static const int SECTION_COUNT = 50;
+static const int SERVICE_COUNT = 40;
+static const int KEY_COUNT = 50;
+
+/* Main file */
+int main()
+{
+    // nested config: sections of services of keys
+    std::string json = "{";
+    char buffer[128];
+    for (int i = 0; i < SECTION_COUNT; ++i) {
+        snprintf(buffer, sizeof(buffer), "%s\"section%d\": {", (i == 0) ? "" : ",", i);
+        json += buffer;
+        for (int j = 0; j < SERVICE_COUNT; ++j) {
+            snprintf(buffer, sizeof(buffer), "%s\"service%d\": {", (j == 0) ? "" : ",", j);
+            json += buffer;
+            for (int k = 0; k < KEY_COUNT; ++k) {
+                snprintf(buffer, sizeof(buffer), "%s\"key%d\": %d", (k == 0) ? "" : ",", k, i * j + k);
+                json += buffer;
+            }
+            json += "}";
+        }
+        json += "}";
+    }
+    json += "}";
+    const char* path = "miniconf_bench_json.json";
+    FILE* fd = fopen(path, "wb");
+    if (!fd) {
+        fprintf(stderr, "Unable to write \"%s\"\n", path);
+        return 1;
+    }
+    fwrite(json.data(), 1, json.size(), fd);
+    fclose(fd);
+
+    // document size
+    size_t allocationsBefore = allocationCount;
+    size_t bytesBefore = liveBytes;
+    {
+        picojson::value document;
+        picojson::parse(document, json);
+        printf("Parsing %d keys, %.1f MB of JSON (%s objects)\n", SECTION_COUNT * SERVICE_COUNT * KEY_COUNT, 
+            json.size() / 1e6, 
+#ifdef PICOJSON_USE_FLAT_OBJECT
+            "flat"
+#else
+            "std::map"
+#endif
+            );
+        printf("    allocations           : %10u\n", static_cast<unsigned int>(allocationCount - allocationsBefore));
+        printf("    document memory       : %10.3f MB\n", (liveBytes - bytesBefore) / 1e6);
+    }
+
+    // parsing and loading
+    double parse = bestOf([&]() {
+        picojson::value document;
+        picojson::parse(document, json);
+    });
+    double load = bestOf([&]() {
+        miniconf::Config conf;
+        conf.config(path);
+    });
+    remove(path);
+
+    printf("    picojson::parse()     : %10.3f ms (best of %d runs)\n", parse, RUN_COUNT);
+    printf("    Config::config()      : %10.3f ms (best of %d runs)\n", load, RUN_COUNT);
+    return 0;
+}
@@ -0,0 +1,72 @@
+/*
+ * miniconf benchmark: memory of large option sets
+ *
+ * Defines 100000 feature flags, one by one via Config::option() and at once 
+ * via Config::options(), and reports the heap memory held by the Config object
+ * per option. The live heap size is tracked by a replaced global operator new.
+ */
+
+#include <cstdio>
+#include <chrono>
+#include <miniconf.h>
+#define MINICONF_BENCH_COUNT_ALLOCATIONS
+#include "bench_common.h"
+
+using miniconf::bench::liveBytes;
+
+// Number of options to be defined
+static const int OPTION_COUNT = 100000;
+
+// Prints the memory and time of defining the options
+static void report(const char* name, size_t bytes, double milliseconds)
+{
+    printf("| %-22s | %12.1f | %10.2f | %10.3f |\n", name, static_cast<double>(bytes) / OPTION_COUNT, 
+        static_cast<double>(bytes) / (1 << 20), milliseconds);
+}
+
+/* Main file */
+int main()
+{
+    typedef std::chrono::steady_clock Clock;
+    std::vector<std::string> flags;
+    for (int i = 0; i < OPTION_COUNT; ++i) {
+        char flag[64];
+        snprintf(flag, sizeof(flag), "features.group%02d.flag%06d", i % 100, i);
+        flags.emplace_back(flag);
+    }
+
+    printf("|------------------------|--------------|------------|------------|\n");
+    printf("|       DEFINITION       | BYTES/OPTION |     MB     |     MS     |\n");
+    printf("|------------------------|--------------|------------|------------|\n");
+
+    // one by one
+    {
+        size_t before = liveBytes;
+        Clock::time_point start = Clock::now();
+        miniconf::Config conf;
+        for (int i = 0; i < OPTION_COUNT; ++i) {
+            conf.option(flags[i]).defaultValue((i % 2) == 0).description("Enables an experimental feature");
+        }
+        double elapsed = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+        report("Config::option()", liveBytes - before, elapsed);
+    }
+
+    // bulk
+    {
+        size_t before = liveBytes;
+        Clock::time_point start = Clock::now();
+        miniconf::Config conf;
+        {
+            std::vector<miniconf::Config::Option> options(OPTION_COUNT);
+            for (int i = 0; i < OPTION_COUNT; ++i) {
+                options[i].flag(flags[i]).defaultValue((i % 2) == 0).description("Enables an experimental feature");
+            }
+            conf.options(std::move(options));
+        }
+        double elapsed = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+        report("Config::options()", liveBytes - before, elapsed);
+    }
+
+    printf("|------------------------|--------------|------------|------------|\n");
+    return 0;
+}
@@ -0,0 +1,61 @@
+/* 
+ * miniconf benchmark: option registration
+ *
+ * Measures the time to define a large number of options, one by one via
+ * Config::option() with and without Config::reserve(), and at once via
+ * Config::options().
+ */
+
+#include <cstdio>
+#include <miniconf.h>
+#include "bench_common.h"
+
+using miniconf::bench::RUN_COUNT;
+using miniconf::bench::bestOf;
+
+// Number of options to be registered
+static const int OPTION_COUNT = 40000;
+
+/* Main file */
+int main()
+{
+    std::vector<std::string> flags;
+    for (int i = 0; i < OPTION_COUNT; ++i) {
+        char flag[64];
+        snprintf(flag, sizeof(flag), "group%d.option%d", i % 100, i);
+        flags.emplace_back(flag);
+    }
+
+    // one by one
+    double single = bestOf([&]() {
+        miniconf::Config conf;
+        for (int i = 0; i < OPTION_COUNT; ++i) {
+            conf.option(flags[i]).defaultValue(i).description("An integer option");
+        }
+    });
+
+    // one by one into reserved space
+    double reserved = bestOf([&]() {
+        miniconf::Config conf;
+        conf.reserve(OPTION_COUNT);
+        for (int i = 0; i < OPTION_COUNT; ++i) {
+            conf.option(flags[i]).defaultValue(i).description("An integer option");
+        }
+    });
+
+    // bulk
+    double bulk = bestOf([&]() {
+        miniconf::Config conf;
+        std::vector<miniconf::Config::Option> options(OPTION_COUNT);
+        for (int i = 0; i < OPTION_COUNT; ++i) {
+            options[i].flag(flags[i]).defaultValue(i).description("An integer option");
+        }
+        conf.options(std::move(options));
+    });
+
+    printf("Registering %d options (best of %d runs)\n", OPTION_COUNT, RUN_COUNT);
+    printf("    Config::option()              : %10.3f ms\n", single);
+    printf("    Config::reserve() + option()  : %10.3f ms\n", reserved);
+    printf("    Config::options()             : %10.3f ms\n", bulk);
+    return 0;
+}
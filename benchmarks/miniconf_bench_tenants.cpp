@@ -0,0 +1,90 @@
+/*
+ * miniconf benchmark: many configs of one schema
+ *
+ * Creates 10000 tenant configs of a schema of 1000 options, each of which
+ * overrides 3 values, and reports the heap memory and the time per tenant:
+ * defining the options for each tenant, copying a prototype Config object,
+ * and binding each tenant to a shared Schema. The live heap size is tracked
+ * by a replaced global operator new.
+ */
+
+#include <cstdio>
+#include <chrono>
+#include <miniconf.h>
+#define MINICONF_BENCH_COUNT_ALLOCATIONS
+#include "bench_common.h"
+
+using miniconf::bench::liveBytes;
+
+// Number of options of the schema
+static const int OPTION_COUNT = 1000;
+
+// Number of tenant configs
+static const int TENANT_COUNT = 10000;
+
+// Defines the options of the schema
+static void defineOptions(miniconf::Config& conf, const std::vector<std::string>& flags)
+{
+    conf.description("A multi-tenant service");
+    conf.log(miniconf::Config::LogLevel::NONE);
+    for (int i = 0; i < OPTION_COUNT; ++i) {
+        conf.option(flags[i]).defaultValue(i).description("A tenant setting");
+    }
+}
+
+// Overrides the values of a tenant
+static void overrideValues(miniconf::Config& conf, const std::vector<std::string>& flags, int tenant)
+{
+    for (int i = 0; i < 3; ++i) {
+        conf[flags[(tenant + i * 7) % OPTION_COUNT]] = tenant;
+    }
+}
+
+// Creates the tenants, and prints their memory and time
+template <typename Func>
+static void measure(const char* name, Func create)
+{
+    typedef std::chrono::steady_clock Clock;
+    std::vector<miniconf::Config> tenants;
+    tenants.reserve(TENANT_COUNT);
+    size_t before = liveBytes;
+    Clock::time_point start = Clock::now();
+    for (int t = 0; t < TENANT_COUNT; ++t) {
+        create(tenants, t);
+    }
+    double elapsed = std::chrono::duration<double, std::micro>(Clock::now() - start).count();
+    printf("| %-22s | %12.1f | %10.3f |\n", name, static_cast<double>(liveBytes - before) / TENANT_COUNT, elapsed / TENANT_COUNT);
+}
+
+/* Main file */
+int main()
+{
+    std::vector<std::string> flags;
+    for (int i = 0; i < OPTION_COUNT; ++i) {
+        char flag[64];
+        snprintf(flag, sizeof(flag), "tenant.section%02d.setting%04d", i % 10, i);
+        flags.emplace_back(flag);
+    }
+    miniconf::Config prototype;
+    defineOptions(prototype, flags);
+    std::shared_ptr<const miniconf::Config::Schema> schema = prototype.schema();
+
+    printf("|------------------------|--------------|------------|\n");
+    printf("|         TENANT         | BYTES/TENANT |  US/TENANT |\n");
+    printf("|------------------------|--------------|------------|\n");
+    measure("Config::option()", [&](std::vector<miniconf::Config>& tenants, int t) {
+        tenants.emplace_back();
+        defineOptions(tenants.back(), flags);
+        overrideValues(tenants.back(), flags, t);
+    });
+    measure("Config copy", [&](std::vector<miniconf::Config>& tenants, int t) {
+        tenants.push_back(prototype);
+        overrideValues(tenants.back(), flags, t);
+    });
+    measure("Config(schema)", [&](std::vector<miniconf::Config>& tenants, int t) {
+        tenants.emplace_back(schema);
+        overrideValues(tenants.back(), flags, t);
+    });
+    printf("|------------------------|--------------|------------|\n");
+    return 0;
+}
@@ -0,0 +1,82 @@
+/*
+ * miniconf benchmark: validation
+ *
+ * Defines 100000 integer options and loads a config file of their values, then
+ * measures range checks over all the values: application checks which look up
+ * each value after validate(), and constraints declared with the options which
+ * validate() checks in one pass.
+ */
+
+#include <cstdio>
+#include <miniconf.h>
+#include "bench_common.h"
+
+using miniconf::bench::RUN_COUNT;
+using miniconf::bench::bestOf;
+
+// Number of options
+static const int OPTION_COUNT = 100000;
+
+// Defines the options, with or without range constraints
+static void defineOptions(miniconf::Config& conf, const std::vector<std::string>& flags, bool constrained)
+{
+    conf.log(miniconf::Config::LogLevel::NONE);
+    for (int i = 0; i < OPTION_COUNT; ++i) {
+        miniconf::Config::Option& o = conf.option(flags[i]).defaultValue(i).description("A parameter");
+        if (constrained) {
+            o.range(0, OPTION_COUNT);
+        }
+    }
+}
+
+/* Main file */
+int main()
+{
+    std::vector<std::string> flags;
+    std::string csv;
+    for (int i = 0; i < OPTION_COUNT; ++i) {
+        char flag[64];
+        snprintf(flag, sizeof(flag), "params.group%02d.param%06d", i % 100, i);
+        flags.emplace_back(flag);
+        csv += flags.back() + "," + std::to_string(OPTION_COUNT - i) + "\n";
+    }
+    const char* csvPath = "miniconf_bench_validate.csv";
+    FILE* fd = fopen(csvPath, "wb");
+    if (!fd) {
+        fprintf(stderr, "Unable to write \"%s\"\n", csvPath);
+        return 1;
+    }
+    fwrite(csv.data(), 1, csv.size(), fd);
+    fclose(fd);
+
+    miniconf::Config manual;
+    defineOptions(manual, flags, false);
+    manual.config(csvPath);
+    size_t failures = 0;
+    double byLookups = bestOf([&]() {
+        failures += (manual.validate() == miniconf::Config::LogLevel::ERROR) ? 1 : 0;
+        for (auto && flag : flags) {
+            int value = manual.value(flag).getInt();
+            failures += (value < 0 || value > OPTION_COUNT) ? 1 : 0;
+        }
+    });
+
+    miniconf::Config constrained;
+    defineOptions(constrained, flags, true);
+    constrained.config(csvPath);
+    double compiling = bestOf([&]() {
+        // modifying an option discards the compiled program
+        constrained.option(flags[0]).description("A parameter");
+        failures += (constrained.validate() == miniconf::Config::LogLevel::ERROR) ? 1 : 0;
+    });
+    double byProgram = bestOf([&]() {
+        failures += (constrained.validate() == miniconf::Config::LogLevel::ERROR) ? 1 : 0;
+    });
+    remove(csvPath);
+
+    printf("Range checks of %d options (best of %d runs)\n", OPTION_COUNT, RUN_COUNT);
+    printf("    validate() and lookups      : %10.3f ms\n", byLookups);
+    printf("    validate() with constraints : %10.3f ms\n", byProgram);
+    printf("    ... including compilation   : %10.3f ms\n", compiling);
+    return failures ? 1 : 0;
+}
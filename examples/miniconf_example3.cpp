@@ -0,0 +1,39 @@
+/* 
+ * miniconf example 3
+ *
+ * The options are defined by a schema file "example3_schema.json", which
+ * is compiled into "example3_schema.h" by miniconf_generate_schema().
+ */
+#include <cstdio>
+#include <miniconf.h>
+#include <example3_schema.h>
+
+/* Main file */
+int main(int argc, char** argv)
+{
+    // create a Config object
+    miniconf::Config conf;
+
+    // Set up program description
+    conf.description("An example for miniconf schema files");
+
+    // Setup config options from the generated schema
+    example3::define(conf);
+
+    // parse 
+    if (conf.parse(argc, argv)){
+        // typed accessors are generated for all options
+        printf("numOpt = %f\n", example3::numOpt(conf));
+        printf("intOpt = %d\n", example3::intOpt(conf));
+        printf("boolOpt = %s\n", example3::boolOpt(conf) ? "true" : "false");
+        printf("strOpt = %s\n", example3::strOpt(conf).c_str());
+        printf("part2.subpart1.value1 = %f\n", example3::part2_subpart1_value1(conf));
+        printf("timeout = %lld ns\n", static_cast<long long>(example3::timeout(conf)));
+        printf("cacheSize = %llu bytes\n", static_cast<unsigned long long>(example3::cacheSize(conf)));
+    } else {
+        printf("Errors in parsing!\n");
+        conf.log();
+    }
+
+    return 0;
+}
@@ -0,0 +1,36 @@
+/* 
+ * miniconf example 4
+ *
+ * The config file "example4_settings.json" is frozen into constexpr values
+ * in "example4_settings.h" by miniconf_freeze_config(). Run it with 
+ * "--config example4_settings.json" to compare them with a runtime load.
+ */
+#include <cstdio>
+#include <cstring>
+#include <miniconf.h>
+#include <example4_settings.h>
+
+/* Main file */
+int main(int argc, char** argv)
+{
+    // frozen values are compile-time constants
+    static_assert(example4::boolOpt, "boolOpt is frozen as true");
+    printf("numOpt = %f\n", example4::numOpt);
+    printf("strOpt = %s\n", example4::strOpt);
+    printf("part2.subpart1.value1 = %s\n", example4::part2::subpart1::value1);
+
+    // compare with the values loaded at runtime
+    miniconf::Config conf;
+    conf.description("An example for frozen config files");
+    conf.log(miniconf::Config::LogLevel::NONE);
+    if (conf.parse(argc, argv) && conf.contains("numOpt")) {
+        bool same = conf.value("numOpt").getNumber() == example4::numOpt &&
+            conf.value("boolOpt").getBoolean() == example4::boolOpt &&
+            conf.value("strOpt").getString() == example4::strOpt &&
+            conf.value("part2.value1").getNumber() == example4::part2::value1 &&
+            strcmp(conf.value("part2.subpart1.value1").getCharArray(), example4::part2::subpart1::value1) == 0;
+        printf("\nRuntime values are %s\n", same ? "the same" : "different");
+    }
+
+    return 0;
+}
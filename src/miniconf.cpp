@@ -0,0 +1,11 @@
+/*
+ * miniconf.cpp
+ *
+ * Compiles the implementation of miniconf.h for the miniconf_static and 
+ * miniconf_shared libraries. Applications which link to one of them define 
+ * MINICONF_LIBRARY, see "Compiled library mode" in miniconf.h.
+ *
+ */
+
+#define MINICONF_IMPLEMENTATION
+#include "miniconf.h"
@@ -22,6 +22,29 @@
  *     Support nested JSON
  * Version 1.5
  *     JSON-less version
+ * Version 1.6
+ *     Bulk loading of config files with shared option definitions
+ *     Layered value sources (default, config file, environment, command line)
+ *     Overlays for cheap per-request overrides, inline storage for small values
+ *     Flag tables generated from schema files
+ *     Config files frozen into constexpr headers
+ *     Shared immutable string buffers, std::string_view access
+ *     64-bit integers, durations and byte sizes
+ *     Shortest round-trip formatting of floating point numbers
+ *     Optional flat JSON objects
+ *     Partial loading of config files by prefix
+ *     Lazy loading of config files
+ *     Configs published in POSIX shared memory
+ *     Journaled persistence of modified values
+ *     Compile-time log level threshold
+ *     Compiled library mode
+ *     Lean build profile without iostream
+ *     Compact option storage for large option sets
+ *     Bit-packed feature flag snapshots
+ *     Typed value column snapshots
+ *     Choice options resolved to integer codes
+ *     Value constraints compiled into a validation program
+ *     Immutable schemas shared by many Config objects
  *
  */
 
@@ -31,14 +54,147 @@
 /* Comment the line below to disable JSON support */
 #define MINICONF_JSON_SUPPORT
 
+/* Log messages below this level are removed at compile time, 0 = INFO, 1 = WARNING, 2 = ERROR, 3 = NONE */
+#ifndef MINICONF_MIN_LOG_LEVEL
+#define MINICONF_MIN_LOG_LEVEL 0
+#endif
+
+/* Compiled library mode
+ *
+ * By default the header is header-only, all functions are defined inline so that it 
+ * can be included from any number of translation units. Define MINICONF_LIBRARY to 
+ * include the declarations only and link to the miniconf_static or miniconf_shared 
+ * library instead, and define MINICONF_IMPLEMENTATION in the one translation unit 
+ * which compiles the implementation. MINICONF_SHARED_LIBRARY exports the symbols of 
+ * a shared library, all other symbols are hidden with -fvisibility=hidden.
+ */
+#if defined(MINICONF_IMPLEMENTATION) && !defined(MINICONF_LIBRARY)
+#define MINICONF_LIBRARY
+#endif
+
+#ifdef MINICONF_LIBRARY
+#define MINICONF_INLINE
+#else
+#define MINICONF_INLINE inline
+#endif
+
+#if !defined(MINICONF_LIBRARY) || defined(MINICONF_IMPLEMENTATION)
+#define MINICONF_DEFINITIONS
+#endif
+
+#if !defined(MINICONF_SHARED_LIBRARY)
+#define MINICONF_API
+#elif defined(_WIN32) && defined(MINICONF_IMPLEMENTATION)
+#define MINICONF_API __declspec(dllexport)
+#elif defined(_WIN32)
+#define MINICONF_API __declspec(dllimport)
+#else
+#define MINICONF_API __attribute__((visibility("default")))
+#endif
+
 #include <string>
 #include <cstring>
-#include <sstream>
-#include <fstream>
+#include <cctype>
+#include <cstdlib>
+#include <climits>
+#include <cstdint>
+#include <cinttypes>
+#include <cerrno>
+#include <cmath>
 #include <map>
 #include <vector>
+#include <algorithm>
+#include <memory>
+#include <new>
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <cstdio>
+
+/* Define MINICONF_LEAN to leave out the stream headers. miniconf reads and writes files 
+ * with stdio only, the headers are kept by default for code which relies on them being 
+ * included, and picojson is included without its stream operators in the lean profile.
+ * Pattern constraints need <regex>, which includes the stream headers, so they are not
+ * available in the lean profile.
+ */
+#ifndef MINICONF_LEAN
+#include <sstream>
+#include <fstream>
+#include <regex>
+#endif
 
-#ifdef MINICONF_JSON_SUPPORT
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <unistd.h>
+#include <fcntl.h>
+#endif
+
+#if __cplusplus >= 201703L || (defined(_MSVC_LANG) && _MSVC_LANG >= 201703L)
+#define MINICONF_HAS_STRING_VIEW
+#include <string_view>
+#if defined(__has_include)
+#if __has_include(<charconv>)
+#include <charconv>
+#if defined(__cpp_lib_to_chars)
+#define MINICONF_HAS_TO_CHARS
+#endif
+#endif
+#endif
+#endif
+
+/* Define MINICONF_SHARED_MEMORY to publish configs in POSIX shared memory */
+#ifdef MINICONF_SHARED_MEMORY
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace miniconf
+{
+    // Size of a buffer which holds any number written by formatNumber(), including the null terminator
+    static const size_t NUMBER_BUFFER_SIZE = 32;
+
+    /* Formats a floating point number with the shortest representation which parses back
+     * to the same number, the decimal point is always "." regardless of the locale. 
+     * std::to_chars is used when it is available, otherwise digits are generated by the
+     * Grisu2 algorithm. Integral numbers below 2^53 are written without exponent. 
+     * Returns the length of the string written to the buffer.
+     */
+    MINICONF_API size_t formatNumber(double value, char* buffer);
+}
+
+#if defined(MINICONF_JSON_SUPPORT) && !defined(MINICONF_DEFINITIONS)
+// picojson is only needed by the implementation
+namespace picojson
+{
+    class value;
+    template <typename Iter> class input;
+}
+#elif defined(MINICONF_JSON_SUPPORT)
+// the stream operators of picojson are left out in the lean profile
+#if defined(MINICONF_LEAN) && !defined(PICOJSON_NO_IOSTREAM) && !defined(picojson_h)
+#define PICOJSON_NO_IOSTREAM
+#endif
+// 64-bit integers are kept exact, unless picojson has been included without it
+#if !defined(PICOJSON_USE_INT64) && !defined(picojson_h)
+#define PICOJSON_USE_INT64
+#endif
+// JSON objects are stored in insertion-ordered vectors instead of std::map if MINICONF_JSON_FLAT_OBJECT is defined
+#if defined(MINICONF_JSON_FLAT_OBJECT) && !defined(PICOJSON_USE_FLAT_OBJECT) && !defined(picojson_h)
+#define PICOJSON_USE_FLAT_OBJECT
+#endif
+// numbers are written in their shortest round-trip representation
+#if !defined(PICOJSON_NUMBER_TO_STR) && !defined(picojson_h)
+#define PICOJSON_NUMBER_TO_STR(n) miniconf::formatNumberString(n)
+namespace miniconf
+{
+    // Formats a floating point number to a string with formatNumber()
+    std::string formatNumberString(double value);
+}
+#endif
 #include "picojson.h"
 #endif
 
@@ -47,11 +203,16 @@ namespace miniconf
 
     /* A flexible container for multiple data type
      *
-     * miniconf::Value is a flexible container for int, double, bool and char array. The 
-     * actual value is stored in a buffer declared during assignment. An extra "unknown"
-     * type is also defined for empty, or invalid value. 
+     * miniconf::Value is a flexible container for int, double, bool and char array, as 
+     * well as 64-bit integers, durations and byte sizes. Durations and byte sizes are 
+     * parsed from strings with units (e.g. "250ms" or "64MiB") once, and stored as 
+     * integers in nanoseconds and bytes respectively. The actual value is stored in a buffer declared during assignment, small values (e.g.
+     * int, double, bool and short strings) are stored inline without allocation. Long
+     * strings are stored in immutable reference counted buffers, which are shared by
+     * the copies of a Value. An extra "unknown" type is also defined for empty, or 
+     * invalid value. 
      */
-    class Value
+    class MINICONF_API Value
     {
         public:
 
@@ -61,7 +222,12 @@ namespace miniconf
                 INT,
                 NUMBER,
                 BOOL,
-                STRING
+                STRING,
+                INT64,
+                UINT64,
+                DURATION, // nanoseconds
+                BYTES,    // bytes
+                CHOICE    // code and name of an allowed value
             };
 
             /* Default constructors and assignments for Value, "unknown" type is assigned
@@ -74,13 +240,13 @@ namespace miniconf
             Value(const Value& other);
             
             // Move assignment constructor 
-            Value(Value&& other);
+            Value(Value&& other) noexcept;
 
             // Assignment operator
             Value& operator=(const Value& other);
 
             // Move assignment operator
-            Value& operator=(Value&& other);
+            Value& operator=(Value&& other) noexcept;
 
             // Default destructor, releases buffer used to hold the value
             ~Value();
@@ -94,11 +260,22 @@ namespace miniconf
             // Constructs a Value instance from a boolean
             explicit Value(const bool& other);
 
+            // Constructs a Value instance from a 64-bit integer
+            explicit Value(const int64_t& other);
+
+            // Constructs a Value instance from an unsigned 64-bit integer
+            explicit Value(const uint64_t& other);
+
             // Constructs a Value instance from a char array
             explicit Value(const char* other);
             
             // Constructs a Value instance from a std::string
             explicit Value(const std::string& other);
+
+#ifdef MINICONF_HAS_STRING_VIEW
+            // Constructs a Value instance from a std::string_view
+            explicit Value(std::string_view other);
+#endif
            
             // Assigns an integer to a Value instance
             Value& operator=(const int& other);
@@ -109,6 +286,12 @@ namespace miniconf
             // Assigns a boolean to a Value instance
             Value& operator=(const bool& other);
             
+            // Assigns a 64-bit integer to a Value instance
+            Value& operator=(const int64_t& other);
+
+            // Assigns an unsigned 64-bit integer to a Value instance
+            Value& operator=(const uint64_t& other);
+
             // Assigns a char array to a Value instance
             Value& operator=(const char* other);
             
@@ -124,11 +307,16 @@ namespace miniconf
             // Casts a Value to a boolean
             explicit operator bool() const;
 
-            // Casts a Value to a char array
-            explicit operator char*() const;
+            // Casts a Value to a char array, the array is shared by copies so it is read-only
+            explicit operator const char*() const;
 
             // Casts a Value to a std::string
             explicit operator std::string() const;
+
+#ifdef MINICONF_HAS_STRING_VIEW
+            // Casts a Value to a std::string_view, which is valid until the Value is modified
+            explicit operator std::string_view() const;
+#endif
            
             // Explicitly gets an integer from a Value instance
             int getInt() const;
@@ -139,31 +327,102 @@ namespace miniconf
             // Explicitly gets a boolean from a Value instance
             bool getBoolean() const;
 
-            // Explicitly gets a char array from a Value instance
-            char* getCharArray() const;
+            // Explicitly gets a 64-bit integer from a Value instance, an integer is widened
+            int64_t getInt64() const;
+
+            // Explicitly gets an unsigned 64-bit integer from a Value instance, an integer is widened
+            uint64_t getUInt64() const;
+
+            // Explicitly gets a duration in nanoseconds from a Value instance
+            int64_t getDuration() const;
+
+            // Explicitly gets a byte size from a Value instance
+            uint64_t getBytes() const;
+
+            // Explicitly gets the code of a choice, -1 if the value is not a choice
+            int getChoice() const;
+
+            // Gets the code of a choice as an enum, the enumerators should match the codes
+            template <typename Enum>
+            Enum getEnum() const;
+
+            // Explicitly gets a char array from a Value instance, the array is shared by copies so it is read-only
+            const char* getCharArray() const;
 
             // Explicitly gets a std::string from a Value instance
             std::string getString() const;
 
+#ifdef MINICONF_HAS_STRING_VIEW
+            // Explicitly gets a std::string_view from a Value instance, which is valid until the Value is modified
+            std::string_view getStringView() const;
+#endif
+
+            // Gets the length of a string without counting its characters
+            size_t length() const;
+
             // Serializes the value to a string
-            std::string print();
+            std::string print() const;
 
             // Serializes the data type of the current value to a string, mainly for debugging purpose
-            std::string printType();
+            std::string printType() const;
 
             // Gets the data type of the current value
-            DataType type();
+            DataType type() const;
 
             // Checks if the value is empty (unknown)
-            bool isEmpty();
+            bool isEmpty() const;
 
             // Generates an unknown (empty) Value object
             static Value unknown();
 
+            // Generates a duration Value object from nanoseconds
+            static Value duration(int64_t nanoseconds);
+
+            // Generates a byte size Value object from a number of bytes
+            static Value bytes(uint64_t count);
+
+            // Generates a choice Value object from its code and name, the name is read as a string
+            static Value choice(int code, const char* name);
+
+            /* Parses a token into a Value object of the given data type, an unknown Value is 
+             * returned if the token cannot be parsed.
+             *
+             * Durations are numbers with units "ns", "us", "ms", "s", "m", "h" and "d", which 
+             * can be combined (e.g. "1h30m"). Byte sizes are numbers with an optional unit "B" 
+             * or a multiple: units with an "i" are binary ("KiB", "MiB", "GiB", "TiB", "PiB", 
+             * "EiB" or "Ki", "Mi", ...), all others are decimal ("kB", "MB", "GB", "TB", "PB", 
+             * "EB" or "k", "M", ..., "K" and "KB" are read as "k" and "kB"). Fractions are 
+             * accepted as long as the result is a whole number, e.g. "1.5KiB".
+             *
+             * A choice is parsed as a string, it is resolved to its code by the Config
+             * object which knows the allowed values.
+             */
+            static Value parse(const char* token, DataType type);
+
+            // Parses a duration string into nanoseconds, returns false if the string is invalid
+            static bool parseDuration(const char* token, int64_t& nanoseconds);
+
+            // Parses a byte size string into bytes, returns false if the string is invalid
+            static bool parseBytes(const char* token, uint64_t& count);
+
         private:
 
-            // Moves value data from a pointer
-            Value& moveData(char*& src, const size_t size, const DataType type);
+            // Header of a reference counted buffer, the value data follows the header
+            struct SharedBuffer {
+                std::atomic<int> refs;
+            };
+
+            // Gets the header of the reference counted buffer of the value data
+            SharedBuffer* sharedBuffer() const;
+
+            // Shares value data with another value, the buffer is not copied
+            Value& shareData(const Value& other);
+
+            // Moves value data from another value, the other value becomes unknown
+            Value& moveData(Value& other);
+
+            // Allocates the buffer of the value data, the data is stored inline if it fits
+            char* allocData(const size_t size);
 
             // Copies value data from a pointer
             Value& copyData(const char* src, const size_t size, const DataType& type);
@@ -177,10 +436,21 @@ namespace miniconf
             // Number of bytes allocated to the buffer
             size_t _size;
 
-            // The pointer to the value buffer
+            // The pointer to the value buffer, it points to _inline for small values, or
+            // the data of a reference counted buffer for large values
             char* _data;
+
+            // Inline buffer for small values
+            alignas(double) char _inline[sizeof(double)];
     };
 
+    // templates are defined with the declarations, so they are available in the library mode too
+    template <typename Enum>
+    inline Enum Value::getEnum() const
+    {
+        return static_cast<Enum>(getChoice());
+    }
+
     /*
      * A Config object describes the configuration settings of an 
      * application. It contains a list of options which can be parsed from 
@@ -203,7 +473,7 @@ namespace miniconf
      * disabled manually). 
      *
      */
-    class Config
+    class MINICONF_API Config
     {
         public:
 
@@ -239,6 +509,27 @@ namespace miniconf
             };
 #endif
 
+            /* Source of an option value
+             *
+             * Option values are stored in separated layers, one for each source. A value
+             * is resolved from the layer of the highest precedence which defines it, the
+             * sources below are listed from the lowest precedence to the highest:
+             * * NONE = The value is not defined in any layer
+             * * DEFAULT = The default value of the option
+             * * CONFIG = Loaded from a config file, e.g. "--config" or config()
+             * * ENVIRONMENT = Loaded from environment variables by environment()
+             * * COMMAND_LINE = Parsed from command line arguments
+             * * USER = Set by the application, e.g. via operator[]
+             */
+            enum class Source {
+                NONE,
+                DEFAULT,
+                CONFIG,
+                ENVIRONMENT,
+                COMMAND_LINE,
+                USER
+            };
+
             /* Option member class which describe the properties of a configuration option.
              * 
              * A complete configuration setting is composed of multiple options, 
@@ -251,9 +542,113 @@ namespace miniconf
              */
             class Option;
 
+            /* Reference member class which is returned by operator[]
+             *
+             * A reference holds a copy of the current value of a flag, which shares the
+             * buffer of a long string, so reading it does not modify any layer. Assigning
+             * to it writes the value to the "USER" layer, or to the layer which supplies
+             * the current value.
+             */
+            class Reference;
+
+            /* Choices member class which is the fixed set of allowed values of an option
+             *
+             * A value of a choice option is one of the allowed strings, it is resolved
+             * to the integer code of the string (its index in the set) by a perfect hash
+             * when it is parsed, so an application switches on the code instead of
+             * comparing strings.
+             */
+            class Choices;
+
+            /* Constraints member struct which limits the values of an option
+             *
+             * Ranges, length limits and patterns are declared with an option. validate()
+             * compiles the constraints of all the options into a flat program, which
+             * checks the values in one pass.
+             */
+            struct Constraints;
+
+            /* Overlay member class which overrides some option values of a Config object
+             *
+             * An overlay references an immutable base Config object and only stores the
+             * overridden values, e.g. per-request settings in a server. Other values are
+             * read from the base object. A few overrides of existing options are stored
+             * in an inline table, so creating a small overlay does not allocate memory.
+             */
+            class Overlay;
+
+            /* FeatureFlags member class which is a snapshot of the boolean options
+             *
+             * Boolean options get dense integer IDs, and their current values are stored
+             * in a bit set, so checking a flag by its ID does not look up any string. 
+             * A snapshot is immutable, it can be read by many threads without locking.
+             */
+            class FeatureFlags;
+
+            /* FeatureStore member class which holds the current FeatureFlags snapshot
+             *
+             * The snapshot is replaced atomically, e.g. when the config is reloaded, and
+             * readers keep the snapshot they loaded until they load it again.
+             */
+            class FeatureStore;
+
+            /* ValueColumns member class which is a snapshot of the values in typed columns
+             *
+             * The values of the options are stored in contiguous arrays per data type,
+             * so bulk operations (e.g. exporting, hashing or comparing all values) are
+             * linear scans instead of lookups in the value layers.
+             */
+            class ValueColumns;
+
+            /* Schema member class which is an immutable set of option definitions
+             *
+             * A schema is built once from the options of a Config object, and shared by
+             * many Config objects, e.g. the tenants of a service. A Config object bound to
+             * a schema only stores its own values until it modifies its options.
+             */
+            class Schema;
+
+#ifdef MINICONF_SHARED_MEMORY
+            /* SharedSegment member class which reads a config published in shared memory
+             *
+             * A config is published by one process, e.g. the master of a prefork server,
+             * and attached read-only by other processes, which neither parse the config
+             * files nor keep a copy of the values.
+             */
+            class SharedSegment;
+#endif
+
+            /* A table which resolves flags to options without searching the option index
+             *
+             * A flag table is usually generated from a schema file by miniconf_schemagen,
+             * which builds a minimal perfect hash over the long and short flags. Flags
+             * which are not found in the table are searched in the option index.
+             */
+            struct FlagTable {
+                // Number of options in the table
+                size_t size;
+
+                // Long flags of the options, indexed by option index
+                const char* const* flags;
+
+                // Returns the option index of a flag (or a short flag), or -1 if it is not in the table
+                int (*find)(const char* flag, size_t length, bool shortflag);
+
+                // Hash function used by the generated perfect hash
+                static uint32_t hash(const char* flag, size_t length, uint32_t seed);
+            };
+
             // Default constructor, no option is defined except the default "help" and "config"
             Config();
 
+            /* Constructs a Config object bound to a schema
+             *
+             * The options, the description and the settings (log level, help, config files,
+             * lazy loading and flag table) are taken from the schema. The option table is 
+             * shared with the schema, and copied if the options of this object are modified.
+             */
+            explicit Config(std::shared_ptr<const Schema> schema);
+
             // Default destructor
             ~Config();
 
@@ -262,15 +657,61 @@ namespace miniconf
              * @argv An array of char array which contains the arguments, the first argument
              * should be the name of the executable
              * @return True when parsing is successful, False when parsing error(s) occur
+             *
+             * The command line values of a previous call are replaced. Files loaded by 
+             * config() stay in the CONFIG layer, a "--config" file is loaded on top of them.
              */
             bool parse(int argc, char** argv);
             
             // Creates a new configuration option, which is uniquely identified by its flag
             Config::Option& option(const std::string& flag);
 
+            // Creates a new configuration option from a moved flag
+            Config::Option& option(std::string&& flag);
+
+            // Creates a new configuration option from a char array
+            Config::Option& option(const char* flag);
+
+#ifdef MINICONF_HAS_STRING_VIEW
+            // Creates a new configuration option from a std::string_view, the flag is copied once
+            Config::Option& option(std::string_view flag);
+#endif
+
+            /* Reserves space for a number of options
+             *
+             * The columns of the option table and its index are allocated once, so
+             * registering many options one by one does not grow and rehash them.
+             */
+            void reserve(size_t count);
+
+            /* Defines many options at once
+             *
+             * The definitions are written to the option table without creating Option
+             * handles, options without a flag are ignored. An existing option with the
+             * same flag is replaced, and the last one is kept if a flag is defined more
+             * than once.
+             */
+            void options(std::vector<Option> options);
+
             // Removes an option
             bool remove(const std::string& flag);
 
+            /* Builds a schema from the current options and settings
+             *
+             * The format of the options is checked once (see checkFormat()), issues are 
+             * logged to this object. The options are copied, so modifying this object does
+             * not change the schema, and its validation program is compiled.
+             */
+            std::shared_ptr<const Schema> schema();
+
+            /* Requires a group of options to be set together
+             *
+             * If any option of the group is set by a config file, an environment variable,
+             * a command line argument or the user, validate() reports the other options of
+             * the group which are not set. The options must be defined before.
+             */
+            void requireTogether(const std::vector<std::string>& flags);
+
             // Checks if the option value is defined in the current configuration
             bool contains(const std::string& flag);
             
@@ -302,27 +743,140 @@ namespace miniconf
             /* Validates user input after parsing / loading config file
              * 
              * This validates the configuration after user input, e.g. all option values are 
-             * defined and not of the UNKNOWN type. This will be called automatically 
-             * after the option values have been parsed in the parse() function. 
+             * defined and not of the UNKNOWN type, and the values meet the constraints of 
+             * their options. This will be called automatically after the option values have 
+             * been parsed in the parse() function. The checks are compiled into a program 
+             * once, which is reused while the options are not modified.
              *
              * @return The most severe level of issue detected by the process
              */
             LogLevel validate();
 
             /* Accesses the configuration value
+             *
+             * The value is read from the layer of the highest precedence. Reading does not
+             * copy a default value to any layer, assigning to the reference writes to the
+             * layer which supplies the value, or to the "USER" layer if the value only
+             * exists as a default value. If the configuration value does not exist, the
+             * reference holds an empty Value object.
+             */
+            Config::Reference operator[](const std::string& flag);
+
+            /* Reads the configuration value without modifying any layer
              *
              * If the configuration value does not exist, an empty Value object is returned. 
              */
-            Value& operator[](const std::string& flag);
+            const Value& value(const std::string& flag) const;
+
+            // Gets the source (layer) which supplies the current value of an option
+            Source source(const std::string& flag) const;
+
+            // Collects the current values of all flags, values of hidden options are excluded
+            void values(std::map<std::string, const Value*>& values) const;
+
+            /* Takes a snapshot of the current values of the boolean options
+             *
+             * The IDs are assigned to the boolean options which are not hidden, in the 
+             * order of their definition. Snapshots share the IDs until an option is
+             * defined, removed or changes its type, so the IDs are stable across reloads
+             * of config files.
+             */
+            std::shared_ptr<const FeatureFlags> featureFlags();
+
+            /* Takes a snapshot of the current values in typed columns
+             *
+             * The IDs are assigned to the options which are neither hidden nor of the 
+             * unknown type, in the order of their definition. As for feature flags, the
+             * IDs are shared by the snapshots until the options are modified.
+             */
+            std::shared_ptr<const ValueColumns> valueColumns();
+
+            /* Swaps the values of a layer with the input values
+             *
+             * The values are exchanged, not copied: the layer takes the values of the map,
+             * and the map receives the previous values of the layer, including the lazily
+             * loaded ones. The default layer is defined by the options and cannot be swapped.
+             *
+             * @return True if the layer is swapped
+             */
+            bool swapLayer(Source source, std::map<std::string, Value>& values);
 
             /* Load the configuration settings via a config file
              * 
              * This function loads a config file, if the config file has been specified in 
              * command line arguments, this will be called automatically in "parse()" function.
              *
+             * By default the values are loaded to the CONFIG layer, so values of the other
+             * layers (e.g. command line arguments) still take precedence over the file, and
+             * source() reports CONFIG for the values which come from the file.
+             *
+             * @configPath the input configuration file path
+             * @source the layer which the values are loaded to
+             * @return False if the file cannot be read or is not valid JSON, nothing is loaded then
+             */
+            bool config(const std::string& configPath, Source source = Source::CONFIG);
+
+            /* Load a part of a config file
+             *
+             * Only the values under a prefix are loaded, the prefix is either a JSON Pointer 
+             * (e.g. "/part2/subpart1") or a dotted prefix (e.g. "part2.subpart1"). Values keep 
+             * their full flags, e.g. "part2.subpart1.value1". The other parts of a JSON file 
+             * are skipped without being materialized.
+             *
              * @configPath the input configuration file path
+             * @prefix the part of the file to be loaded, the whole file is loaded if it is empty
+             * @source the layer which the values are loaded to
+             * @return False if the file cannot be read or is not valid JSON, nothing is loaded then
+             */
+            bool config(const std::string& configPath, const std::string& prefix, Source source = Source::CONFIG);
+
+            /* Load option values from environment variables
+             *
+             * The variable name of an option is its flag in upper case with a prefix, other
+             * characters than letters and digits are replaced by "_", e.g. the variable of
+             * option "a.b" is "APP_A_B" if the prefix is "APP_".
+             *
+             * @prefix the prefix of the variable names
+             */
+            void environment(const std::string& prefix = "");
+
+            /* Loads many config files into independent Config instances
+             *
+             * Each result is a copy of "schema" which shares its option definitions, then
+             * the config file is loaded and validated as "parse()" does for "--config".
+             * Files are read and parsed concurrently by a pool of worker threads, results
+             * are returned in the same order as the input paths.
+             *
+             * @paths the input configuration file paths
+             * @schema a Config object whose options are defined
+             * @status receives the status of each path: ERROR if the file cannot be read
+             * or is not valid JSON, otherwise the result of validate()
+             * @threads number of worker threads, 0 means the hardware concurrency
+             */
+            static std::vector<Config> loadMany(const std::vector<std::string>& paths, const Config& schema, 
+                std::vector<LogLevel>& status, unsigned int threads = 0);
+
+            // Loads many config files, the status of each path is only logged to its result
+            static std::vector<Config> loadMany(const std::vector<std::string>& paths, const Config& schema, unsigned int threads = 0);
+
+#ifdef MINICONF_SHARED_MEMORY
+            /* Publishes the current values in POSIX shared memory
+             *
+             * The values are written to a new segment of the next generation, then the 
+             * generation counter of the name is increased, so that the attached readers
+             * can switch to the new segment. The segment of the previous generation is
+             * unlinked, it remains valid until all readers detach from it. A name should 
+             * only be published by one process.
+             *
+             * @name the name of the shared memory, e.g. "/myapp-config"
+             * @mode the permissions of the shared memory segments
+             * @return True if the values are published
              */
-            void config(const std::string& configPath);
+            bool publish(const std::string& name, unsigned int mode = 0600);
+
+            // Removes the shared memory segments of a published name, attached readers are not affected
+            static bool unpublish(const std::string& name);
+#endif
 
             /* Serializes the current configuration
              *
@@ -334,18 +888,63 @@ namespace miniconf
             std::string serialize(const std::string& serializeFilePath = "", ExportFormat format = ExportFormat::CSV, bool pretty = true);
 #endif
 
+            /* Persists modified values in a journal
+             *
+             * The values in the snapshot file and the journal file (the path with a ".journal"
+             * suffix) are replayed to the "USER" layer, then each value modified by set() is 
+             * appended to the journal as a compact binary record. Records are written and 
+             * synced by a background thread, all the records appended during one sync are 
+             * written together (group commit). When the journal grows over compactSize bytes,
+             * it is compacted into the snapshot by the background thread. A copy of the Config
+             * object (e.g. a result of loadMany()) starts without a journal, so diverging copies
+             * never write to the same files. Records use the byte order of the machine.
+             *
+             * @path the snapshot file path
+             * @compactSize the size of the journal which triggers a compaction
+             * @return True if the snapshot and the journal are replayed
+             */
+            bool journal(const std::string& path, size_t compactSize = 1 << 20);
+
+            /* Sets a value in the "USER" layer
+             *
+             * The value is appended to the journal if there is one, the record is durable
+             * after sync() returns. A choice may be set by its name, a name which is not 
+             * allowed is rejected.
+             */
+            void set(const std::string& flag, const Value& value);
+
+            // Waits until all the values set so far are written and synced, returns false if the journal cannot be written
+            bool sync();
+
             // Enables automatically generated help message (--help/-h)
             void enableHelp(bool enabled = true);
 
             // Ennables setting via external config file (--config/-cfg)
             void enableConfig(bool enabled = true);
 
+            /* Enables lazy loading of config files
+             *
+             * The content of a lazily loaded config file is retained, only the positions
+             * of its values are recorded while the file is tokenized. A value is converted
+             * to the data type of its option on first access, and the conversion is done
+             * once even if the value is read by many threads. Lazily loaded values are not
+             * converted by validate() unless their options have constraints, an invalid 
+             * value is read as an empty Value object.
+             */
+            void enableLazyLoading(bool enabled = true);
+
             // Prints usage of this program's configuration options
             void usage(FILE* fd = stdout);
 
             // Prints a automatically generated help message 
             void help(FILE* fd = stdout);
 
+            /* Sets a flag table to resolve flags when parsing arguments and config files
+             *
+             * The table must outlive the Config object, nullptr removes the table.
+             */
+            void flagTable(const FlagTable* table);
+
         private:
 
             /* Types of command line arguments
@@ -362,47 +961,173 @@ namespace miniconf
                 VALUE       // value, e.g. 123, "hello", true
             };
 
-            // Sets default values to option values, used in parse() for initialization
-            void setDefaultValues();
+            // Compact storage of the options
+            class OptionTable;
+
+            // Checks of the option values compiled from the option table
+            class Validator;
+
+            // Values of a config file which are converted on first access
+            class LazyValues;
+
+            // Append-only journal of modified values
+            class Journal;
+
+            // Gets the values of a layer, source must be one of the non-default layers
+            std::map<std::string, Value>& layer(Source source);
+
+            // Gets the lazily loaded values of a layer, the values of the latest file are at the back
+            std::vector<std::shared_ptr<const LazyValues>>& lazyLayer(Source source);
+
+            // Finds the current value and its source of a flag, returns nullptr if the value is not defined
+            const Value* lookup(const std::string& flag, Source* source = nullptr) const;
+
+            // Gets the value of a flag to be modified, a default value is copied to the "USER" layer first
+            Value& modifiable(const std::string& flag);
+
+            // Finds the source of the current value of a flag, lazily loaded values are not converted
+            Source locate(const std::string& flag) const;
+
+            // Resolves the names of choices in a layer to their codes, names which are not allowed are removed
+            LogLevel resolveChoices(Source source);
+
+            // Gets the option table for modification, it is copied first if shared with other instances
+            OptionTable& mutableOptions();
+
+            // Gets the option returned by option() for a row, it is created on first use
+            Option& handle(uint32_t row);
+
+            // Gets the program description, the description of the schema is not copied to the bound objects
+            const std::string& programDescription() const;
 
             // get current token type
             TokenType getTokenType(const char* token);
 
             // since long flag is the key for the option directory,
-            // this function transltes short flag to long flag
-            std::string translateShortflag(const std::string& shortflag);
+            // this function searches for the row of the option of a short flag
+            uint32_t translateShortflag(const char* shortflag, size_t length);
 
-            // search for options using token
-            Option* getOption(const char* token, Config::TokenType tokenType);
+            // search for the row of an option using token
+            uint32_t getOption(const char* token, Config::TokenType tokenType);
+
+            // search for the row of an option by its flag or short flag, the flag table is used if it is set
+            uint32_t resolveOption(const char* flag, size_t length, bool shortflag);
 
             // determine is a flag is defined in the config
            bool findOption(const std::string& flag);
 
-            // parse a token into Value
-            Value parseValue(const char* token, Value::DataType dataType);
+            // split a JSON Pointer or a dotted prefix into keys
+            static std::vector<std::string> splitPrefix(const std::string& prefix);
+
+            // read the content of a file, returns false if it cannot be opened
+            static bool readFile(const std::string& path, std::string& content);
 
 #ifdef MINICONF_JSON_SUPPORT
-            // load json config string
-            bool loadJSON(const std::string& JSONStr);
+            // picojson parse context which only materializes the subtree selected by a path of keys
+            class SubtreeParseContext;
+
+            // picojson parse context which records the positions of the values for lazy loading
+            class LazyParseContext;
+
+            // skip a json value without materializing it, only its structure is checked
+            template <typename Iter>
+            static bool skipJSONValue(picojson::input<Iter>& in);
+
+            // load json config string, only the subtree selected by the path is loaded, returns false if it is not valid JSON
+            bool loadJSON(const std::string& JSONStr, const std::vector<std::string>& path, Source source);
 
             // parse a json value
-            bool parseJSON(const picojson::value *v, const std::string& flag); 
+            bool parseJSON(const picojson::value *v, const std::string& flag, Source source); 
 
             // load a value from json
-            bool getJSONValue(const picojson::value *v, const std::string& flag); 
+            bool getJSONValue(const picojson::value *v, const std::string& flag, Source source); 
+
+            // convert a value to json, 64-bit integers are written as strings if they cannot be represented exactly
+            static picojson::value toJSONValue(const Value& v);
+
+            // convert a json value to a value of the given data type, the type of the json value is kept if
+            // the data type is unknown. an unknown value is returned on failure
+            static Value fromJSONValue(const picojson::value *v, Value::DataType type);
 #endif
 
-            // load csv config string
-            bool loadCSV(const std::string& CSVStr);
+            // load csv config string, only the flags under the path are loaded
+            bool loadCSV(const std::string& CSVStr, const std::vector<std::string>& path, Source source);
+
+            // load config string lazily, only the positions of the values under the path are recorded
+            bool loadLazy(std::string&& content, ExportFormat format, const std::vector<std::string>& path, Source source);
+
+            /* internal function for adding log messages
+             *
+             * The message is concatenated from its parts (strings, char arrays or numbers), which
+             * are only converted if the message is kept. Messages below MINICONF_MIN_LOG_LEVEL
+             * are removed at compile time when the level is a constant.
+             */
+            template <typename Token, typename... Parts>
+            void log(LogLevel logType, const Token& token, const Parts&... msg);
+
+            /* checks if a message of a level is kept by log()
+             *
+             * Callers check it before building expensive parts of a message, it is false at 
+             * compile time for levels below MINICONF_MIN_LOG_LEVEL.
+             */
+            bool logEnabled(LogLevel logType) const;
+
+            // adds a log message which has been built
+            void addLog(LogLevel logType, const std::string& token, const std::string& msg);
+
+            // appends parts of a log message to a string
+            static void appendLog(std::string& out);
+            template <typename Part, typename... Parts>
+            static void appendLog(std::string& out, const Part& part, const Parts&... parts);
+
+            // converts a part of a log message, numbers are formatted
+            static const char* logPart(const char* part);
+            static const char* logPart(char* part);
+            static const std::string& logPart(const std::string& part);
+            template <typename Number>
+            static std::string logPart(const Number& part);
+
+            // this table stores configuration format design, e.g. flag, default values.
+            // it is shared by copies of the Config object until one of them modifies it
+            std::shared_ptr<OptionTable> _options;
+
+            /* Options returned by option(), by row
+             *
+             * They modify the option table of this object, so a copy of the Config object
+             * starts without any, and they are dropped when another Config object is assigned.
+             */
+            struct OptionHandles {
+                OptionHandles();
+                OptionHandles(const OptionHandles& other);
+                OptionHandles& operator=(const OptionHandles& other);
+
+                // a map keeps the options in place when it grows
+                std::map<uint32_t, Option> options;
+            };
+            OptionHandles _handles;
+
+            // number of the non-default layers, from "CONFIG" to "USER"
+            static const int LAYERS = static_cast<int>(Source::USER) - static_cast<int>(Source::CONFIG) + 1;
 
-            // internal function for adding log messages
-            void log(LogLevel logType, const std::string& token, const std::string& msg);
+            // these maps store the values of the non-default layers, from "CONFIG" to "USER"
+            std::map<std::string, Value> _layers[LAYERS];
 
-            // this map stores configuration format design, e.g. flag, default values.
-            std::map<std::string, Option> _options;
+            // lazily loaded values of the non-default layers, they are shadowed by the values in _layers
+            std::vector<std::shared_ptr<const LazyValues>> _lazyLayers[LAYERS];
+
+            /* journal of the values modified by set()
+             *
+             * It writes the values of this object only, so a copy of the Config object starts
+             * without one, and it is closed when another Config object is assigned.
+             */
+            struct JournalHandle {
+                JournalHandle();
+                JournalHandle(const JournalHandle& other);
+                JournalHandle& operator=(const JournalHandle& other);
 
-            // this map stores the values parsed form user input
-            std::map<std::string, Value> _optionValues;
+                std::shared_ptr<Journal> journal;
+            };
+            JournalHandle _journal;
 
             // this is a stack of log messages
             std::vector<std::string> _log;
@@ -425,43 +1150,171 @@ namespace miniconf
             // switch for enable loading configuration
             bool _loadConfig; 
 
+            // switch for lazy loading of config files
+            bool _lazyLoading;
+
+            // flag table for resolving flags, it is not owned by the Config object
+            const FlagTable* _flagTable;
+
+            // rows of the options resolved from the flag table, indexed by option index
+            std::vector<uint32_t> _flagTableOptions;
+
+            // the last feature flag snapshot, its IDs are reused while the options are not modified
+            std::shared_ptr<const FeatureFlags> _featureFlags;
+
+            // the last value column snapshot, its layout is reused while the options are not modified
+            std::shared_ptr<const ValueColumns> _valueColumns;
+
+            // the compiled validation program, it is reused while the options are not modified
+            std::shared_ptr<const Validator> _validator;
+
+            // the schema which this object is bound to, or nullptr
+            std::shared_ptr<const Schema> _schema;
+
     };
 
     /*
-     * Describe one configuration options
-     * A complete configuration setting is composed of multiple options, 
-     * each option is responsible for one property. Each option can be 
-     * invoked by its flag (e.g. --flag) or shortened flag (e.g. -f). 
-     * Some options are required to be set manually, while some options
-     * have default values such that user input is not always required.
-     * 
-     * The data type of an option is determined from its defaultValue.
+     * The allowed values of a choice option
+     *
+     * The codes are the indices of the names, a minimal perfect hash over the names
+     * is built when the set is constructed. The set is immutable and shared by the
+     * copies of the option.
      */
-    class Config::Option
+    class MINICONF_API Config::Choices
     {
         public:
 
-            /* Default constructor that creates a empty option
-             *
-             * Use should use Config::option(flag) to create an new option
-             */
-            Option();
+            // Constructs a set from the allowed names, a duplicated name keeps its first code
+            explicit Choices(const std::vector<std::string>& names);
 
-            // Default destructor
-            ~Option();
+            // Finds the code of a name, returns -1 if the name is not allowed
+            int find(const char* name, size_t length) const;
 
-            // Sets the flag of an option
-            Config::Option& flag(const std::string& flag);
+            // Gets the name of a code
+            const char* name(int code) const;
 
-            // Sets the short flag of an option
+            // Gets the choice Value of a code, copies of the value share its buffer
+            const Value& value(int code) const;
+
+            // Number of allowed values
+            size_t size() const;
+
+            // Lists the allowed names separated by ", ", e.g. for error messages
+            std::string list() const;
+
+        private:
+
+            // Builds the perfect hash, returns false if no displacement is found
+            bool buildHash();
+
+            // Allowed names, indexed by code
+            std::vector<std::string> _names;
+
+            // Choice values, indexed by code
+            std::vector<Value> _values;
+
+            // Displacements of the buckets of the perfect hash, empty if names are searched linearly
+            std::vector<uint32_t> _displacements;
+
+            // Codes of the slots of the perfect hash
+            std::vector<int> _slots;
+    };
+
+    /*
+     * The constraints of the values of an option
+     *
+     * Constraints are immutable and shared by the copies of the option, an option
+     * without constraints does not store any.
+     */
+    struct Config::Constraints {
+        // Bounds of a numeric value, an empty Value leaves a side unbounded
+        Value minimum;
+        Value maximum;
+
+        // Bounds of the length of a string value
+        size_t minLength = 0;
+        size_t maxLength = SIZE_MAX;
+
+#ifndef MINICONF_LEAN
+        // ECMAScript pattern which a whole string value must match, and its compiled regex
+        std::string pattern;
+        std::shared_ptr<const std::regex> regex;
+#endif
+    };
+
+    /*
+     * Describe one configuration options
+     * A complete configuration setting is composed of multiple options, 
+     * each option is responsible for one property. Each option can be 
+     * invoked by its flag (e.g. --flag) or shortened flag (e.g. -f). 
+     * Some options are required to be set manually, while some options
+     * have default values such that user input is not always required.
+     * 
+     * The data type of an option is determined from its defaultValue.
+     *
+     * The Option returned by Config::option() modifies the option stored in 
+     * the Config object which returned it, copies of that Config object are 
+     * not modified. Other options (e.g. the ones created by the default
+     * constructor for Config::options()) hold their own definitions. A copy 
+     * of an option always holds its own definition.
+     */
+    class MINICONF_API Config::Option
+    {
+        public:
+
+            /* Default constructor that creates a empty option
+             *
+             * Use should use Config::option(flag) to create an new option
+             */
+            Option();
+
+            // Copy constructor
+            Option(const Option& other);
+
+            // Move constructor
+            Option(Option&& other);
+
+            // Assignment operator
+            Option& operator=(const Option& other);
+
+            // Move assignment operator
+            Option& operator=(Option&& other);
+
+            // Default destructor
+            ~Option();
+
+            // Sets the flag of an option
+            Config::Option& flag(const std::string& flag);
+
+            // Sets the flag of an option from a moved string
+            Config::Option& flag(std::string&& flag);
+
+            // Sets the short flag of an option
             Config::Option& shortflag(const std::string& shortflag);
 
+            // Sets the short flag of an option from a moved string
+            Config::Option& shortflag(std::string&& shortflag);
+
             // Sets the description of an option
             Config::Option& description(const std::string& description);
 
+            // Sets the description of an option from a moved string
+            Config::Option& description(std::string&& description);
+
+            // Sets the description of an option from a char array
+            Config::Option& description(const char* description);
+
+#ifdef MINICONF_HAS_STRING_VIEW
+            // Sets the description of an option from a std::string_view
+            Config::Option& description(std::string_view description);
+#endif
+
             // Sets the default value of an option from a Value object
             Config::Option& defaultValue(const Value& defaultValue);
 
+            // Sets the default value of an option from a moved Value object
+            Config::Option& defaultValue(Value&& defaultValue);
+
             // Sets the default value of an option from an integer
             Config::Option& defaultValue(const int& defaultValue);
             
@@ -470,6 +1323,12 @@ namespace miniconf
             
             // Sets the default value of an option from a boolean
             Config::Option& defaultValue(const bool& defaultValue);
+
+            // Sets the default value of an option from a 64-bit integer
+            Config::Option& defaultValue(const int64_t& defaultValue);
+
+            // Sets the default value of an option from an unsigned 64-bit integer
+            Config::Option& defaultValue(const uint64_t& defaultValue);
             
             // Sets the default value of an option from a char array
             Config::Option& defaultValue(const char* defaultValue);
@@ -477,6 +1336,40 @@ namespace miniconf
             // Sets the default value of an option from a string
             Config::Option& defaultValue(const std::string& defaultValue);
 
+#ifdef MINICONF_HAS_STRING_VIEW
+            // Sets the default value of an option from a std::string_view
+            Config::Option& defaultValue(std::string_view defaultValue);
+#endif
+
+            /* Makes an option a choice of a fixed set of allowed values
+             *
+             * The default value and the parsed values must be one of the names, they
+             * are stored as choice values with the codes of the names.
+             */
+            Config::Option& choices(const std::vector<std::string>& names);
+
+            /* Limits the numeric values of an option, the bounds are inclusive
+             *
+             * An empty Value leaves a side unbounded. Integer values are compared with
+             * integer bounds exactly, e.g. durations with Value::duration() bounds.
+             */
+            Config::Option& range(const Value& minimum, const Value& maximum);
+
+            // Limits the numeric values of an option to a range of numbers
+            Config::Option& range(double minimum, double maximum);
+
+            // Limits the length of the string values of an option
+            Config::Option& length(size_t minimum, size_t maximum = SIZE_MAX);
+
+#ifndef MINICONF_LEAN
+            /* Requires the string values of an option to match a regular expression
+             *
+             * The ECMAScript pattern is compiled once when it is set, and the whole value
+             * must match. An invalid pattern is reported by checkFormat().
+             */
+            Config::Option& pattern(const std::string& pattern);
+#endif
+
             // Makes an option to be required or optional
             Config::Option& required(const bool required);
 
@@ -486,1134 +1379,6406 @@ namespace miniconf
              */
             Config::Option& hidden(const bool hidden);
 
-            // Prints the flag of an option as a string
-            std::string flag();
+            // Gets the flag of an option
+            std::string flag() const;
+
+            // Gets the shortflag of an option
+            std::string shortflag() const;
 
-            // Prints the shortflag of an option as a string
-            std::string shortflag();
+            // Gets the description of an option
+            std::string description() const;
 
-            // Prints the description of an option
-            std::string description();
+#ifdef MINICONF_HAS_STRING_VIEW
+            /* Gets the flag, short flag and description without copying them
+             *
+             * The views of an option stored in a Config object point into the string pool
+             * of its option table, they are only valid until the options of that object are
+             * modified, e.g. by the next call of option(), options() or remove().
+             */
+            std::string_view flagView() const;
+            std::string_view shortflagView() const;
+            std::string_view descriptionView() const;
+#endif
 
-            // Returns the default value of an option
-            Value defaultValue();
+            // Returns the default value of an option, without copying it
+            const Value& defaultValue() const;
 
             // Checks if the option is required or optional
-            bool required();
+            bool required() const;
 
             // Gets the data type 
-            Value::DataType type();
+            Value::DataType type() const;
 
             // Checks if an option is hidden
-            bool hidden();
+            bool hidden() const;
+
+            // Gets the allowed values of a choice option, nullptr if it is not a choice
+            std::shared_ptr<const Choices> choices() const;
+
+            // Gets the constraints of an option, nullptr if it has none
+            std::shared_ptr<const Constraints> constraints() const;
 
         private:
 
-            // Flag of the option
-            std::string     _flag;          
-            
-            // Shortened flag of the option
-            std::string     _shortflag;     
-            
-            // Description of the option
-            std::string     _description;   
-            
-            // Default value of the option
-            Value           _defaultValue;
-            
-            // Option is required to be specified
-            bool            _required;
-            
-            // Option is hidden
-            bool            _hidden;
+            // Definition of an option which is not stored in a Config object
+            struct Definition {
+                std::string     flag;
+                std::string     shortflag;
+                std::string     description;
+                Value           defaultValue;
+                bool            required;
+                bool            hidden;
+                std::shared_ptr<const Choices> choices;
+                std::shared_ptr<const Constraints> constraints;
+            };
 
-    };
+            // Copies the constraints of the option to be modified, or creates them
+            std::shared_ptr<Constraints> copyConstraints() const;
 
-    /*********************************************************************/
-    /*********************************************************************/
-    /*********************** IMPLEMENTATION BELOW ************************/
-    /*********************************************************************/
-    /*********************************************************************/
+            // Sets the constraints of the option
+            Config::Option& constraints(std::shared_ptr<const Constraints> constraints);
 
-    // Value
-    Value::Value() : _type(DataType::UNKNOWN), _size(0), _data(nullptr)
-    {}
+            // Copies the definition of the option
+            Definition definition() const;
 
-    Value::Value(const Value& other) : Value()
-    {
-        copyData(other._data, other._size, other._type);
-    }
+            // Sets the definition of the option
+            void assign(const Definition& definition);
 
-    Value::Value(Value&& other) : Value()
-    {
-        moveData(other._data, other._size, other._type);
-    }
+            // Gets the definition of an option which is not stored in a table, it is created on first modification
+            const Definition& detached() const;
+            Definition& mutableDetached();
 
+            // Gets the option table of the Config object which stores the option
+            const OptionTable& table() const;
 
-    Value& Value::operator=(const Value& other)
-    {
-        clearData();
-        return copyData(other._data, other._size, other._type);
-    }
+            // Gets the option table of the Config object for modification
+            OptionTable& mutableTable();
 
-    Value& Value::operator=(Value&& other)
-    {
-        return moveData(other._data, other._size, other._type);
-    }
+            // Config object which stores the option, or nullptr
+            Config*         _owner;
 
-    Value::~Value()
-    {
-        clearData();
-    }
+            // Row of the option in the table of the Config object
+            uint32_t        _row;
 
-    //  int
-    Value::Value(const int& other) : Value()
-    {
-        copyData(reinterpret_cast<const char*>(&other), sizeof(int), DataType::INT);
-    }
+            // Definition of the option if it is not stored in a Config object
+            std::unique_ptr<Definition> _definition;
 
-    Value& Value::operator=(const int& other)
-    {
-        clearData();
-        return copyData(reinterpret_cast<const char*>(&other), sizeof(int), DataType::INT);
-    }
+            friend class Config;
 
-    Value::operator int() const
-    {
-        return *reinterpret_cast<int*>(_data);
-    }
+    };
 
-    int Value::getInt() const
+    /*
+     * Compact storage of the options of a Config object
+     *
+     * Options are stored in rows of parallel arrays. The columns used by parsing 
+     * and value lookups (hash of the flag, default value and bits) are kept apart
+     * from the text of the flags and descriptions, which are offsets into one 
+     * string pool. Rows are indexed by the hashes of their flags and short flags.
+     * Removed rows are only dropped when the table is compacted by a copy, so the
+     * rows stay valid as long as a table is modified in place.
+     */
+    class MINICONF_API Config::OptionTable
     {
-        return *reinterpret_cast<int*>(_data);
-    }
+        public:
 
-    //  number (floating point)
-    Value::Value(const double& other) : Value()
-    {
-        copyData(reinterpret_cast<const char*>(&other), sizeof(double), DataType::NUMBER);
-    }
+            // Row of an option which does not exist
+            static const uint32_t NONE = UINT32_MAX;
 
-    Value& Value::operator=(const double& other)
-    {
-        clearData();
-        return copyData(reinterpret_cast<const char*>(&other), sizeof(double), DataType::NUMBER);
-    }
+            // Constructs an empty table
+            OptionTable();
 
-    Value::operator double() const
-    {
-        return *reinterpret_cast<double*>(_data);
-    }
+            // Copies the options of a table, removed rows are dropped
+            OptionTable(const OptionTable& other);
 
-    double Value::getNumber() const
-    {
-        return *reinterpret_cast<double*>(_data);
-    }
+            // Copies the options of a table, the rows are kept if it is not compacted
+            OptionTable(const OptionTable& other, bool compact);
 
+            // Tables are shared instead of assigned
+            OptionTable& operator=(const OptionTable& other) = delete;
 
-    //  bool
-    Value::Value(const bool& other) : Value()
-    {
-        copyData(reinterpret_cast<const char*>(&other), sizeof(bool), DataType::BOOL);
-    }
+            // Number of rows, including the removed ones
+            size_t rows() const;
 
-    Value& Value::operator=(const bool& other)
-    {
-        clearData();
-        return copyData(reinterpret_cast<const char*>(&other), sizeof(bool), DataType::BOOL);
-    }
+            // Reserves the columns and the indexes for a number of rows
+            void reserve(size_t count);
 
-    Value::operator bool() const
-    {
-        return *reinterpret_cast<bool*>(_data);
-    }
+            // Finds the row of a flag, returns NONE if the option does not exist
+            uint32_t find(const char* flag, size_t length) const;
 
-    bool Value::getBoolean() const
-    {
-        return *reinterpret_cast<bool*>(_data);
-    }
+            // Finds the row of a short flag, the first option is returned if the short flag is duplicated
+            uint32_t findShortflag(const char* shortflag, size_t length) const;
 
-    //  char array
-    Value::Value(const char* other) : Value()
-    {
-        copyData(other, strlen(other) + 1, DataType::STRING);
-    }
+            // Finds the row of a flag, a row is appended if the option does not exist
+            uint32_t insert(const char* flag, size_t length);
 
-    Value& Value::operator=(const char* other)
-    {
-        clearData();
-        return copyData(other, strlen(other) + 1, DataType::STRING);
-    }
+            // Removes the option of a row
+            void remove(uint32_t row);
 
-    Value::operator char*() const
-    {
-        return reinterpret_cast<char*>(_data);
-    }
+            // Rows of the options sorted by their flags
+            std::vector<uint32_t> sorted() const;
 
-    char* Value::getCharArray() const
-    {
-        return reinterpret_cast<char*>(_data);
-    }
+            // Columns of a row
+            bool removed(uint32_t row) const;
+            bool required(uint32_t row) const;
+            bool hidden(uint32_t row) const;
+            bool duplicateShortflag(uint32_t row) const;
+            const Value& defaultValue(uint32_t row) const;
+            Value::DataType type(uint32_t row) const;
+            const char* flag(uint32_t row) const;
+            const char* shortflag(uint32_t row) const;
+            const char* description(uint32_t row) const;
+            const std::shared_ptr<const Choices>& choices(uint32_t row) const;
+            const std::shared_ptr<const Constraints>& constraints(uint32_t row) const;
 
-    //  std::string
-    Value::Value(const std::string& other) : Value()
-    {
-        copyData(other.c_str(), other.size() + 1, DataType::STRING);
-    }
+            // Allowed values of the choice options, by row
+            const std::map<uint32_t, std::shared_ptr<const Choices>>& choices() const;
 
-    Value& Value::operator=(const std::string& other)
-    {
-        clearData();
-        return copyData(other.c_str(), other.size() + 1, DataType::STRING);
-    }
+            // Constraints of the options, by row
+            const std::map<uint32_t, std::shared_ptr<const Constraints>>& constraints() const;
 
-    Value::operator std::string() const
-    {
-        return std::string(reinterpret_cast<char*>(_data));
-    }
+            // Groups of the rows of options which are required together
+            const std::vector<std::vector<uint32_t>>& groups() const;
 
-    std::string Value::getString() const
-    {
-        return std::string(reinterpret_cast<char*>(_data));
-    }
+            // Adds a group of rows which are required together
+            void group(std::vector<uint32_t>&& rows);
 
-    // print function
-    std::string Value::print()
-    {
-        const int slen = 31;
-        char tempStr[slen + 1];
-        std::string outStr;
-        switch (_type) {
-            case DataType::UNKNOWN:
-                snprintf(tempStr, slen, "null");
-                break;
-            case DataType::INT:
-                snprintf(tempStr, slen, "%d", getInt());
-                outStr = std::string(tempStr);
-                break;
-            case DataType::NUMBER:
-                snprintf(tempStr, slen, "%f", getNumber());
-                outStr = std::string(tempStr);
-                break;
-            case DataType::BOOL:
-                snprintf(tempStr, slen, "%s", getBoolean() ? "true" : "false");
-                outStr = std::string(tempStr);
-                break;
-            case DataType::STRING:
-                outStr = "\"" + std::string(getCharArray()) + "\"";
-                break;
-            default:
-                break;
-        }
-        return outStr;
-    }
+            // Modifies the columns of a row
+            void flag(uint32_t row, const char* flag, size_t length);
+            void shortflag(uint32_t row, const char* shortflag, size_t length);
+            void description(uint32_t row, const char* description, size_t length);
+            void defaultValue(uint32_t row, Value&& defaultValue);
+            void required(uint32_t row, bool required);
+            void hidden(uint32_t row, bool hidden);
+            void choices(uint32_t row, std::shared_ptr<const Choices> choices);
+            void constraints(uint32_t row, std::shared_ptr<const Constraints> constraints);
 
-    // return data type
-    Value::DataType Value::type()
-    {
-        return _type;
-    }
+        private:
 
-    // check empty
-    bool Value::isEmpty()
-    {
-        return (_data == nullptr || _type == DataType::UNKNOWN);
-    }
+            // Bits of a row
+            static const uint8_t REQUIRED = 1;
+            static const uint8_t HIDDEN = 2;
+            static const uint8_t REMOVED = 4;
+            static const uint8_t DUPLICATE_SHORTFLAG = 8;
+
+            // Offsets of the text of a row in the string pool
+            struct Strings {
+                uint32_t flag;
+                uint32_t shortflag;
+                uint32_t description;
+            };
 
-    // generate unknown value
-    Value Value::unknown()
-    {
-        return Value();
-    }
+            // Appends a null terminated string to the pool, the empty string is at offset 0
+            uint32_t pool(const char* text, size_t length);
 
-    // print value data type
-    std::string Value::printType()
-    {
-        std::string outStr;
-        const int slen = 15;
-        char tempStr[slen + 1];
-        switch (_type) {
-            case DataType::UNKNOWN:
-                snprintf(tempStr, slen, "UNKNOWN");
-                break;
-            case DataType::INT:
-                snprintf(tempStr, slen, "INT");
-                break;
-            case DataType::NUMBER:
-                snprintf(tempStr, slen, "NUMBER");
-                break;
-            case DataType::BOOL:
-                snprintf(tempStr, slen, "BOOLEAN");
-                break;
-            case DataType::STRING:
-                snprintf(tempStr, slen, "STRING");
-                break;
-            default:
-                break;
-        }
-        return std::string(tempStr);
-    }
+            // Checks if a pooled string is equal to a string
+            bool equals(uint32_t offset, const char* text, size_t length) const;
 
-    // move and copy function
-    Value& Value::moveData(char*& src, const size_t size, const DataType type)
-    {
-        _type = type;
-        _size = size;
-        _data = src;
-        src = nullptr;
-        return *this;
-    }
+            // Marks a pooled string as unused
+            void release(uint32_t offset);
 
-    // internal use
-    Value& Value::copyData(const char* src, const size_t size, const DataType& type)
-    {
-        char* newData = new char[size];
-        memcpy(newData, src, size);
-        return moveData(newData, size, type);
-    }
+            // Rebuilds the string pool from the strings of the rows which are not removed, when most of it is unused
+            void compactPool();
 
-    // internal use
-    void Value::clearData()
-    {
-        if (_size != 0 && _data != nullptr) {
-            delete _data;
-            _data = nullptr;
-        }
-    }
+            // Adds a row to the indexes, the indexes are rebuilt if they are too small
+            void index(uint32_t row);
 
-    // Option
-    Config::Option::Option() : _flag(), _shortflag(), _description(), _defaultValue(Value::unknown()), _required(false), _hidden(false)
+            // Rebuilds the indexes from the rows which are not removed, with room for a number of options
+            void rebuildIndex(size_t count);
+
+            // Adds the flag of a row to the flag index
+            void indexFlag(uint32_t row);
+
+            // Adds the short flag of a row to the short flag index
+            void indexShortflag(uint32_t row);
+
+            // Removes the flag of a row from the flag index
+            void unindexFlag(uint32_t row);
+
+            // Removes the short flag of a row from the short flag index, the duplicates of the short flag are indexed again
+            void unindexShortflag(uint32_t row);
+
+            // Empties a slot of an index, the following rows of the probe sequence are shifted back
+            void eraseSlot(std::vector<uint32_t>& index, size_t slot, bool shortflags);
+
+            // Hash of the flag of each row
+            std::vector<uint32_t> _hashes;
+
+            // Default value of each row
+            std::vector<Value> _defaultValues;
+
+            // Bits of each row
+            std::vector<uint8_t> _bits;
+
+            // Text of each row
+            std::vector<Strings> _strings;
+
+            // Null terminated strings of the flags and descriptions
+            std::string _pool;
+
+            // Size of the strings in the pool which are no longer used
+            size_t _garbage;
+
+            // Allowed values of the few choice options, they are not stored for each row
+            std::map<uint32_t, std::shared_ptr<const Choices>> _choices;
+
+            // Constraints of the few constrained options
+            std::map<uint32_t, std::shared_ptr<const Constraints>> _constraints;
+
+            // Groups of rows which are required together, removed rows are kept until the table is copied
+            std::vector<std::vector<uint32_t>> _groups;
+
+            // Open addressing indexes of the rows by flag and by short flag, the sizes are powers of 2
+            std::vector<uint32_t> _index;
+            std::vector<uint32_t> _shortflagIndex;
+
+            // Number of rows which are not removed
+            size_t _size;
+    };
+
+    /*
+     * Checks of the option values compiled into a flat program
+     *
+     * Each option which is not hidden has an instruction which checks that its
+     * value is defined, followed by the instructions of its constraints, so the
+     * value of an option is looked up once for all its checks. The program is run
+     * in one pass over the options, large programs are split into ranges of
+     * options which are run in parallel. Groups of options which are required
+     * together are checked after the pass.
+     */
+    class MINICONF_API Config::Validator
+    {
+        public:
+
+            // Compiles the checks of the options of a table, the table is shared by the program
+            explicit Validator(std::shared_ptr<const OptionTable> options);
+
+            // Runs the program over the values of a Config object, failed checks are logged
+            LogLevel run(Config& config) const;
+
+        private:
+
+            // Number of instructions from which a program is run in parallel
+            static const size_t PARALLEL_INSTRUCTIONS = 1 << 16;
+
+            // Operations of the instructions
+            enum class Op : uint8_t {
+                DEFINED,        // the value is defined and valid, the first instruction of an option
+                MIN_INTEGER,    // integer >= operand
+                MAX_INTEGER,    // integer <= operand
+                MIN_NUMBER,     // number >= operand
+                MAX_NUMBER,     // number <= operand
+                MIN_LENGTH,     // string length >= operand
+                MAX_LENGTH,     // string length <= operand
+                PATTERN         // string matches the pattern of the option
+            };
+
+            // An instruction checks one value against one operand
+            struct Instruction {
+                Op op;
+                uint32_t row;
+                union {
+                    int64_t integer;
+                    double number;
+                    uint64_t length;
+                    size_t pattern;     // index of the compiled pattern
+                };
+            };
+
+            // A failed check, DEFINED fails for undefined or invalid values
+            struct Failure {
+                uint32_t instruction;
+                bool undefined;
+            };
+
+            // Appends an instruction of an option, the operand is set by the caller
+            Instruction& append(Op op, uint32_t row);
+
+            // Checks a defined value against an instruction
+            bool check(const Instruction& instruction, const Value& value) const;
+
+            // Runs a range of instructions which starts at an option, the sources of the values are stored by row
+            void run(const Config& config, size_t begin, size_t end, std::vector<Failure>& failures, std::vector<uint8_t>& sources) const;
+
+            // Finds the first instruction of the option at or after an instruction
+            size_t align(size_t instruction) const;
+
+            // Logs a failed check, returns its level
+            LogLevel report(Config& config, const Failure& failure) const;
+
+            // Appends the instructions of a numeric bound
+            void bound(uint32_t row, const Value& bound, bool minimum);
+
+            // Option table which is compiled
+            std::shared_ptr<const OptionTable> _options;
+
+            // Instructions, grouped by option, each option starts with a DEFINED instruction
+            std::vector<Instruction> _instructions;
+
+#ifndef MINICONF_LEAN
+            // Compiled patterns, shared with the constraints of the options
+            std::vector<std::shared_ptr<const std::regex>> _patterns;
+#endif
+
+            // Groups of the rows of options which are required together
+            std::vector<std::vector<uint32_t>> _groups;
+
+            friend class Config;
+    };
+
+    /*
+     * Immutable option definitions shared by many Config objects
+     *
+     * A schema is built by Config::schema(). The Config objects constructed from it
+     * share its option table and validation program, and parse() does not check the
+     * format of the options again.
+     */
+    class MINICONF_API Config::Schema
+    {
+        public:
+
+            // Most severe level of the issues found by checkFormat() when the schema was built
+            LogLevel format() const;
+
+            // Number of options, including the hidden "help" and "config" options
+            size_t size() const;
+
+            // Checks if an option is defined
+            bool contains(const std::string& flag) const;
+
+            // Gets the description of the program
+            const std::string& description() const;
+
+        private:
+
+            // Creates an empty schema, schemas are built by Config::schema()
+            Schema();
+
+            // Option table, it is never modified
+            std::shared_ptr<OptionTable> _options;
+
+            // Validation program of the option table
+            std::shared_ptr<const Validator> _validator;
+
+            // Result of checkFormat()
+            LogLevel _format;
+
+            // Description and settings of the Config object which built the schema
+            std::string _description;
+            bool _verbose;
+            LogLevel _logLevel;
+            bool _autoHelp;
+            bool _loadConfig;
+            bool _lazyLoading;
+            const FlagTable* _flagTable;
+
+            friend class Config;
+    };
+
+    /*
+     * Overrides some option values of a base Config object
+     *
+     * The base object must outlive the overlay, and its options must not be
+     * modified while the overlay is in use. Values which are not overridden are
+     * read from the base object.
+     */
+    class MINICONF_API Config::Reference : public Value
+    {
+        public:
+
+            // Assigns a Value object
+            Config::Reference& operator=(const Value& other);
+
+            // Assigns a moved Value object
+            Config::Reference& operator=(Value&& other);
+
+            // Assigns the value of another reference
+            Config::Reference& operator=(const Reference& other);
+
+            // Assigns an integer
+            Config::Reference& operator=(const int& other);
+
+            // Assigns a floating point
+            Config::Reference& operator=(const double& other);
+
+            // Assigns a boolean
+            Config::Reference& operator=(const bool& other);
+
+            // Assigns a 64-bit integer
+            Config::Reference& operator=(const int64_t& other);
+
+            // Assigns an unsigned 64-bit integer
+            Config::Reference& operator=(const uint64_t& other);
+
+            // Assigns a char array
+            Config::Reference& operator=(const char* other);
+
+            // Assigns a std::string
+            Config::Reference& operator=(const std::string& other);
+
+        private:
+
+            // References are created by Config::operator[]
+            Reference(Config& config, const std::string& flag, const Value* value);
+
+            // Config object which the value is written to
+            Config* _config;
+
+            // Flag of the value
+            std::string _flag;
+
+            friend class Config;
+    };
+
+    class MINICONF_API Config::Overlay
+    {
+        public:
+
+            // Constructs an overlay without any overridden value
+            explicit Overlay(const Config& base);
+
+            // Overrides the value of a flag
+            Config::Overlay& set(const std::string& flag, const Value& value);
+
+            // Overrides the value of a flag with a moved value
+            Config::Overlay& set(const std::string& flag, Value&& value);
+
+            /* Accesses the overridden value of a flag
+             *
+             * If the flag is not overridden yet, the value of the base object is 
+             * copied to the overlay first.
+             */
+            Value& operator[](const std::string& flag);
+
+            /* Reads the value of a flag, from the overlay or from the base object
+             *
+             * If the configuration value does not exist, an empty Value object is returned. 
+             */
+            const Value& value(const std::string& flag) const;
+
+            // Checks if the value of a flag is overridden by the overlay
+            bool overrides(const std::string& flag) const;
+
+            // Removes all the overridden values
+            void clear();
+
+            // Gets the base Config object
+            const Config& base() const;
+
+        private:
+
+            // Number of overridden values stored inline
+            static const size_t INLINE_SIZE = 8;
+
+            // An inline overridden value, the flag points to the flag of an option of the base
+            struct Entry {
+                const char* flag;
+                Value value;
+            };
+
+            // Finds the overridden value of a flag, returns nullptr if the flag is not overridden
+            const Value* find(const std::string& flag) const;
+
+            // Gets the overridden value of a flag, the value is inserted if it does not exist
+            Value* slot(const std::string& flag, bool& inserted);
+
+            // The base Config object
+            const Config* _base;
+
+            // Number of inline overridden values
+            size_t _size;
+
+            // Inline overridden values
+            Entry _entries[INLINE_SIZE];
+
+            // Overridden values of flags which are not options of the base, or do not fit inline
+            std::map<std::string, Value> _spill;
+    };
+
+    /*
+     * Bit set of the boolean options of a Config object
+     *
+     * The snapshot keeps the option table it was taken from, so the flags of the
+     * IDs are available without copying them.
+     */
+    class MINICONF_API Config::FeatureFlags
+    {
+        public:
+
+            // ID of a flag which is not a feature flag
+            static const uint32_t NONE = UINT32_MAX;
+
+            /* Checks if a feature flag is enabled
+             *
+             * An ID which is not less than size(), e.g. NONE returned by id() for an 
+             * unknown flag, is never enabled.
+             */
+            bool isEnabled(uint32_t id) const;
+
+            // Gets the ID of a feature flag, or NONE if the flag is not a boolean option
+            uint32_t id(const std::string& flag) const;
+
+            // Gets the flag of an ID
+            const char* flag(uint32_t id) const;
+
+            // Number of feature flags
+            size_t size() const;
+
+        private:
+
+            // Creates an empty snapshot, snapshots are taken by Config::featureFlags()
+            FeatureFlags();
+
+            // Option table of the Config object
+            std::shared_ptr<const OptionTable> _options;
+
+            // Rows of the feature flags in the option table, indexed by ID, in ascending order
+            std::shared_ptr<const std::vector<uint32_t>> _rows;
+
+            // Values of the feature flags, one bit per ID, followed by a word which is always zero
+            std::vector<uint64_t> _words;
+
+            friend class Config;
+    };
+
+    // the check is defined with the declarations, so it is inlined in the library mode too
+    inline bool Config::FeatureFlags::isEnabled(uint32_t id) const
+    {
+        // IDs past the flags read the last word instead of a branch
+        const size_t word = std::min<size_t>(id >> 6, _words.size() - 1);
+        return ((_words[word] >> (id & 63)) & 1) != 0;
+    }
+
+    /*
+     * Holds the current feature flag snapshot of an application
+     *
+     * load() and store() are atomic, a request handler loads the snapshot once and
+     * checks its flags without further synchronization.
+     */
+    class MINICONF_API Config::FeatureStore
+    {
+        public:
+
+            // Constructs a store without a snapshot
+            FeatureStore();
+
+            // Constructs a store with a snapshot
+            explicit FeatureStore(std::shared_ptr<const FeatureFlags> flags);
+
+            // Gets the current snapshot, nullptr if no snapshot is stored
+            std::shared_ptr<const FeatureFlags> load() const;
+
+            // Replaces the current snapshot
+            void store(std::shared_ptr<const FeatureFlags> flags);
+
+        private:
+
+            // The current snapshot, only accessed by the atomic shared_ptr functions
+            std::shared_ptr<const FeatureFlags> _flags;
+    };
+
+    /*
+     * Values of the options of a Config object in typed columns
+     *
+     * Integers (INT, INT64, UINT64, DURATION, BYTES and CHOICE codes) are stored as int64_t, 
+     * numbers as double, booleans as one byte each, and strings as offsets into
+     * one string pool. Each column keeps the IDs of its values, and each ID is
+     * mapped to the slot of its value in the column of its type.
+     */
+    class MINICONF_API Config::ValueColumns
+    {
+        public:
+
+            // ID of a flag which is not in the snapshot
+            static const uint32_t NONE = UINT32_MAX;
+
+            // View of the contiguous values of a column, and the IDs of their options
+            template <typename T>
+            struct Column {
+                const T* values;
+                const uint32_t* ids;
+                size_t size;
+            };
+
+            // Gets the ID of a flag, or NONE if the option is not in the snapshot
+            uint32_t id(const std::string& flag) const;
+
+            // Gets the flag of an ID
+            const char* flag(uint32_t id) const;
+
+            // Number of options in the snapshot
+            size_t size() const;
+
+            // Gets the data type of an option
+            Value::DataType type(uint32_t id) const;
+
+            // Checks if an option has a value, e.g. a required option may be undefined
+            bool defined(uint32_t id) const;
+
+            // Gets the value of an option, an unknown Value is returned if it is undefined
+            Value value(uint32_t id) const;
+
+            // Integer values and codes of choices, UINT64 and BYTES values are cast to int64_t
+            Column<int64_t> ints() const;
+
+            // Floating point values
+            Column<double> numbers() const;
+
+            // Boolean values, 0 or 1
+            Column<uint8_t> booleans() const;
+
+            // String values as offsets into stringPool(), the strings are terminated by '\0'
+            Column<uint32_t> strings() const;
+
+            // Pool of the string values
+            const std::string& stringPool() const;
+
+            // Hashes all the values, e.g. to check if a reloaded config file changes anything
+            uint64_t hash() const;
+
+            /* Collects the IDs of the values which differ from another snapshot
+             *
+             * @return False if the snapshots are taken of different options
+             */
+            bool diff(const ValueColumns& other, std::vector<uint32_t>& ids) const;
+
+        private:
+
+            // IDs, data types and slots shared by the snapshots of the same options
+            struct Layout {
+                std::vector<uint32_t> rows;
+                std::vector<Value::DataType> types;
+                std::vector<uint32_t> slots;
+                std::vector<uint32_t> ids[4];
+            };
+
+            // Creates an empty snapshot, snapshots are taken by Config::valueColumns()
+            ValueColumns();
+
+            // Gets the column of a data type, -1 if values of the type are not stored
+            static int column(Value::DataType type);
+
+            // Checks if the snapshots are taken of the same options
+            bool sameLayout(const ValueColumns& other) const;
+
+            // Option table of the Config object
+            std::shared_ptr<const OptionTable> _options;
+
+            // Layout of the columns
+            std::shared_ptr<const Layout> _layout;
+
+            // Values of the columns
+            std::vector<int64_t> _ints;
+            std::vector<double> _numbers;
+            std::vector<uint8_t> _booleans;
+            std::vector<uint32_t> _strings;
+            std::string _pool;
+
+            // 1 if the option of an ID has a value, indexed by ID
+            std::vector<uint8_t> _defined;
+
+            friend class Config;
+    };
+
+    /*
+     * Values of a lazily loaded config file
+     *
+     * The content of the file is retained, and each value is recorded as a slice of
+     * the content with the data type of its option. The slices are indexed by their
+     * flags once the file is tokenized, a value is converted from its slice when it
+     * is first accessed. The values are immutable after sealed, except the converted
+     * values which are initialized once, so they can be shared by copies of a Config.
+     */
+    class MINICONF_API Config::LazyValues
+    {
+        public:
+
+            // Constructs an empty set of values of the content
+            LazyValues(std::string&& content, ExportFormat format);
+
+            // Gets the retained content
+            const std::string& content() const;
+
+            // Records the value of a flag at [offset, offset + length) of the content, the data type of a stray value is unknown
+            void add(std::string&& flag, size_t offset, size_t length, Value::DataType type);
+
+            // Indexes the values by their flags, only the last recorded value of a flag is kept
+            void seal();
+
+            // Number of values
+            size_t size() const;
+
+            // Gets the flag of a value
+            const std::string& flag(size_t index) const;
+
+            // Gets a value, it is converted from the content on first access
+            const Value& value(size_t index) const;
+
+            // Finds the index of a flag, returns size() if it is not recorded
+            size_t find(const std::string& flag) const;
+
+        private:
+
+            // The position of a value in the content
+            struct Slice {
+                std::string flag;
+                size_t offset;
+                size_t length;
+                Value::DataType type;
+            };
+
+            // A converted value
+            struct Cache {
+                std::once_flag once;
+                Value value;
+            };
+
+            // An empty slot of the index
+            static const uint32_t EMPTY = UINT32_MAX;
+
+            // Converts a value from the content
+            Value convert(const Slice& slice) const;
+
+            // Finds the slot of a flag in the index, the slot is either empty or holds the index of the flag
+            size_t findSlot(const std::string& flag) const;
+
+            // The retained content of the file
+            std::string _content;
+
+            // Format of the content
+            ExportFormat _format;
+
+            // Positions of the values
+            std::vector<Slice> _slices;
+
+            // Open addressing index of the flags, which holds indices of the slices
+            std::vector<uint32_t> _index;
+
+            // Converted values, indexed as the slices
+            std::unique_ptr<Cache[]> _cache;
+    };
+
+    /*
+     * Append-only journal of modified values
+     *
+     * Each record holds a checksum, the lengths of the flag and the value, the data type,
+     * the flag and the value, so a record which is partially written by a crash is 
+     * detected when it is replayed. Records are appended to a pending buffer, a writer
+     * thread writes the buffer and syncs the file in one batch. The snapshot has the same
+     * format, it is written to a temporary file and renamed, then the journal is emptied
+     * once the rename is synced. Compaction runs on the writer thread after the batch
+     * which triggered it is synced. Replaying a journal which has been compacted into
+     * the snapshot again is harmless.
+     */
+    class MINICONF_API Config::Journal
+    {
+        public:
+
+            // Constructs a journal of a snapshot file, the journal is not opened yet
+            Journal(const std::string& path, size_t compactSize);
+
+            // Writes the pending records and stops the writer thread
+            ~Journal();
+
+            Journal(const Journal&) = delete;
+            Journal& operator=(const Journal&) = delete;
+
+            // Replays the snapshot and the journal to values, then starts the writer thread
+            bool open(std::map<std::string, Value>& values);
+
+            // Appends a record
+            void append(const std::string& flag, const Value& value);
+
+            // Waits until all the appended records are synced, returns false if the journal cannot be written
+            bool sync();
+
+        private:
+
+            // Size of the fixed part of a record: checksum, flag length, value length and data type
+            static const size_t HEADER_SIZE = 13;
+
+            // Appends the record of a value to a buffer
+            static void encode(std::string& out, const std::string& flag, const Value& value);
+
+            // Decodes a record, returns false if the record is incomplete or corrupted
+            static bool decode(const char*& p, const char* end, std::string& flag, Value& value);
+
+            // Replays the records of a file, returns false if it ends with an invalid record, a missing file is empty
+            static bool replay(const std::string& path, std::map<std::string, Value>& values);
+
+            // Flushes and syncs a file
+            static bool syncFile(FILE* fd);
+
+            // Syncs the directory of a file, so that a renamed file is durable
+            static bool syncDirectory(const std::string& path);
+
+            // Writes values to the snapshot, then empties the journal
+            bool writeSnapshot(const std::map<std::string, Value>& values);
+
+            // Compacts the journal into the snapshot
+            bool compact();
+
+            // The writer thread
+            void run();
+
+            // Path of the snapshot, the journal path has a ".journal" suffix
+            std::string _path;
+
+            // Size of the journal which triggers a compaction
+            size_t _compactSize;
+
+            // The journal file, it is only written by the writer thread after opened
+            FILE* _file;
+
+            // Size of the journal file
+            size_t _size;
+
+            // Records which are not written yet
+            std::string _pending;
+
+            // Number of appended records
+            uint64_t _appended;
+
+            // Number of synced records
+            uint64_t _synced;
+
+            // Set if the journal cannot be written
+            bool _failed;
+
+            // Set when the writer thread should stop
+            bool _stop;
+
+            // Guards the pending records and the counters
+            std::mutex _mutex;
+
+            // Wakes up the writer thread when records are appended
+            std::condition_variable _appendedCond;
+
+            // Wakes up the waiters of sync() when records are synced
+            std::condition_variable _syncedCond;
+
+            // The writer thread
+            std::thread _writer;
+    };
+
+#ifdef MINICONF_SHARED_MEMORY
+    /*
+     * Read-only view of a config published in POSIX shared memory
+     *
+     * The values of a generation are stored in one segment, which begins with a header
+     * and a table of entries sorted by flags, followed by the flags and the strings. All
+     * references in the segment are offsets, so it is mapped by many processes at any
+     * address without being parsed. A small control segment holds the current generation 
+     * of a name, refresh() checks it with one atomic load and maps the new segment if it
+     * has changed. A view must not be refreshed while it is read by other threads.
+     */
+    class MINICONF_API Config::SharedSegment
+    {
+        public:
+
+            // Constructs a view which is not attached
+            SharedSegment();
+
+            // Unmaps the segments
+            ~SharedSegment();
+
+            SharedSegment(const SharedSegment&) = delete;
+            SharedSegment& operator=(const SharedSegment&) = delete;
+
+            // Attaches to the latest generation published under a name, returns false if nothing is published
+            bool attach(const std::string& name);
+
+            // Switches to the latest generation if a newer one is published, returns true if it is switched
+            bool refresh();
+
+            // Unmaps the segments
+            void detach();
+
+            // Gets the generation of the attached values, it is 0 if the view is not attached
+            uint64_t generation() const;
+
+            // Number of values
+            size_t size() const;
+
+            // Checks if a flag has a value
+            bool contains(const std::string& flag) const;
+
+            /* Reads the value of a flag
+             *
+             * Numbers, booleans and short strings are read without allocation, long strings are 
+             * copied to the returned Value. If the flag does not exist, an empty Value is returned.
+             */
+            Value value(const std::string& flag) const;
+
+            /* Reads a string or the name of a choice without copying it
+             *
+             * The returned null terminated chars point into the read-only mapping, which is
+             * shared by all the processes, they are valid until refresh() switches to another 
+             * generation or detach() is called. nullptr is returned if the flag does not exist
+             * or its value is not a string.
+             */
+            const char* stringData(const std::string& flag, size_t& length) const;
+
+#ifdef MINICONF_HAS_STRING_VIEW
+            // Reads a string as std::string_view into the mapping, which is valid until refresh() or detach()
+            std::string_view stringView(const std::string& flag) const;
+#endif
+
+        private:
+
+            // Control segment of a name, the memory is zero filled when it is created
+            struct Control {
+                char magic[8];
+                std::atomic<uint64_t> generation;
+            };
+
+            // Header of a segment of values
+            struct Header {
+                char magic[8];
+                uint64_t generation;
+                uint64_t size;
+                uint64_t count;
+            };
+
+            // A value, strings are stored at an offset of the segment, other values are stored in the data bits
+            struct Entry {
+                uint64_t flag;
+                uint32_t flagLength;
+                uint32_t type;
+                uint64_t data;
+                uint64_t length;
+            };
+
+            // Maps a segment read-only, returns nullptr on failure
+            static const char* map(const std::string& name, size_t& size);
+
+            // Finds the entry of a flag, returns nullptr if it is not found
+            const Entry* find(const std::string& flag) const;
+
+            // Name of the published config
+            std::string _name;
+
+            // The mapped control segment
+            const Control* _control;
+
+            // The mapped segment of values
+            const char* _data;
+
+            // Size of the mapped segment of values
+            size_t _size;
+
+            friend class Config;
+    };
+#endif
+
+    /*********************************************************************/
+    /*********************************************************************/
+    /*********************** IMPLEMENTATION BELOW ************************/
+    /*********************************************************************/
+    /*********************************************************************/
+#ifdef MINICONF_DEFINITIONS
+
+    // Value
+    MINICONF_INLINE Value::Value() : _type(DataType::UNKNOWN), _size(0), _data(nullptr)
+    {}
+
+    MINICONF_INLINE Value::Value(const Value& other) : Value()
+    {
+        shareData(other);
+    }
+
+    MINICONF_INLINE Value::Value(Value&& other) noexcept : Value()
+    {
+        moveData(other);
+    }
+
+
+    MINICONF_INLINE Value& Value::operator=(const Value& other)
+    {
+        if (this == &other) {
+            return *this;
+        }
+        clearData();
+        return shareData(other);
+    }
+
+    MINICONF_INLINE Value& Value::operator=(Value&& other) noexcept
+    {
+        if (this == &other) {
+            return *this;
+        }
+        clearData();
+        return moveData(other);
+    }
+
+    MINICONF_INLINE Value::~Value()
+    {
+        clearData();
+    }
+
+    //  int
+    MINICONF_INLINE Value::Value(const int& other) : Value()
+    {
+        copyData(reinterpret_cast<const char*>(&other), sizeof(int), DataType::INT);
+    }
+
+    MINICONF_INLINE Value& Value::operator=(const int& other)
+    {
+        clearData();
+        return copyData(reinterpret_cast<const char*>(&other), sizeof(int), DataType::INT);
+    }
+
+    MINICONF_INLINE Value::operator int() const
+    {
+        return *reinterpret_cast<int*>(_data);
+    }
+
+    MINICONF_INLINE int Value::getInt() const
+    {
+        return *reinterpret_cast<int*>(_data);
+    }
+
+    //  number (floating point)
+    MINICONF_INLINE Value::Value(const double& other) : Value()
+    {
+        copyData(reinterpret_cast<const char*>(&other), sizeof(double), DataType::NUMBER);
+    }
+
+    MINICONF_INLINE Value& Value::operator=(const double& other)
+    {
+        clearData();
+        return copyData(reinterpret_cast<const char*>(&other), sizeof(double), DataType::NUMBER);
+    }
+
+    MINICONF_INLINE Value::operator double() const
+    {
+        return *reinterpret_cast<double*>(_data);
+    }
+
+    MINICONF_INLINE double Value::getNumber() const
+    {
+        return *reinterpret_cast<double*>(_data);
+    }
+
+
+    //  bool
+    MINICONF_INLINE Value::Value(const bool& other) : Value()
+    {
+        copyData(reinterpret_cast<const char*>(&other), sizeof(bool), DataType::BOOL);
+    }
+
+    MINICONF_INLINE Value& Value::operator=(const bool& other)
+    {
+        clearData();
+        return copyData(reinterpret_cast<const char*>(&other), sizeof(bool), DataType::BOOL);
+    }
+
+    MINICONF_INLINE Value::operator bool() const
+    {
+        return *reinterpret_cast<bool*>(_data);
+    }
+
+    MINICONF_INLINE bool Value::getBoolean() const
+    {
+        return *reinterpret_cast<bool*>(_data);
+    }
+
+    //  64-bit integer
+    MINICONF_INLINE Value::Value(const int64_t& other) : Value()
+    {
+        copyData(reinterpret_cast<const char*>(&other), sizeof(int64_t), DataType::INT64);
+    }
+
+    MINICONF_INLINE Value& Value::operator=(const int64_t& other)
+    {
+        clearData();
+        return copyData(reinterpret_cast<const char*>(&other), sizeof(int64_t), DataType::INT64);
+    }
+
+    MINICONF_INLINE int64_t Value::getInt64() const
+    {
+        return (_type == DataType::INT) ? getInt() : *reinterpret_cast<int64_t*>(_data);
+    }
+
+    //  unsigned 64-bit integer
+    MINICONF_INLINE Value::Value(const uint64_t& other) : Value()
+    {
+        copyData(reinterpret_cast<const char*>(&other), sizeof(uint64_t), DataType::UINT64);
+    }
+
+    MINICONF_INLINE Value& Value::operator=(const uint64_t& other)
+    {
+        clearData();
+        return copyData(reinterpret_cast<const char*>(&other), sizeof(uint64_t), DataType::UINT64);
+    }
+
+    MINICONF_INLINE uint64_t Value::getUInt64() const
+    {
+        return (_type == DataType::INT) ? static_cast<uint64_t>(getInt()) : *reinterpret_cast<uint64_t*>(_data);
+    }
+
+    //  duration and byte size, stored as 64-bit integers
+    MINICONF_INLINE Value Value::duration(int64_t nanoseconds)
+    {
+        Value v;
+        v.copyData(reinterpret_cast<const char*>(&nanoseconds), sizeof(int64_t), DataType::DURATION);
+        return v;
+    }
+
+    MINICONF_INLINE int64_t Value::getDuration() const
+    {
+        return *reinterpret_cast<int64_t*>(_data);
+    }
+
+    MINICONF_INLINE Value Value::bytes(uint64_t count)
+    {
+        Value v;
+        v.copyData(reinterpret_cast<const char*>(&count), sizeof(uint64_t), DataType::BYTES);
+        return v;
+    }
+
+    MINICONF_INLINE uint64_t Value::getBytes() const
+    {
+        return *reinterpret_cast<uint64_t*>(_data);
+    }
+
+    //  choice, the name and its terminator are followed by the code
+    MINICONF_INLINE Value Value::choice(int code, const char* name)
+    {
+        int32_t code32 = static_cast<int32_t>(code);
+        std::string data(name, strlen(name) + 1);
+        data.append(reinterpret_cast<const char*>(&code32), sizeof(code32));
+        Value v;
+        v.copyData(data.data(), data.size(), DataType::CHOICE);
+        return v;
+    }
+
+    MINICONF_INLINE int Value::getChoice() const
+    {
+        if (_type != DataType::CHOICE) {
+            return -1;
+        }
+        int32_t code;
+        memcpy(&code, _data + _size - sizeof(int32_t), sizeof(int32_t));
+        return code;
+    }
+
+    namespace detail
+    {
+        // A unit of measurement, the multiplier converts a number to the canonical unit
+        struct Unit {
+            const char* name;
+            uint64_t multiplier;
+        };
+
+        // A table of units, the first outputCount units are used for output, the others only when parsing
+        struct UnitTable {
+            const Unit* units;
+            size_t count;
+            size_t outputCount;
+        };
+
+        // Units of a duration in nanoseconds
+        inline const UnitTable& durationUnits()
+        {
+            static const Unit units[] = {
+                { "h", 3600000000000ull }, { "m", 60000000000ull }, { "s", 1000000000ull }, 
+                { "ms", 1000000ull }, { "us", 1000ull }, { "ns", 1ull }, 
+                // accepted when parsing only
+                { "d", 86400000000000ull }, { "min", 60000000000ull }, { "\xc2\xb5s", 1000ull }
+            };
+            static const UnitTable table = { units, sizeof(units) / sizeof(units[0]), 6 };
+            return table;
+        }
+
+        // Units of a size in bytes
+        inline const UnitTable& byteUnits()
+        {
+            static const Unit units[] = {
+                { "EiB", 1ull << 60 }, { "EB", 1000000000000000000ull }, { "PiB", 1ull << 50 }, { "PB", 1000000000000000ull },
+                { "TiB", 1ull << 40 }, { "TB", 1000000000000ull }, { "GiB", 1ull << 30 }, { "GB", 1000000000ull },
+                { "MiB", 1ull << 20 }, { "MB", 1000000ull }, { "KiB", 1ull << 10 }, { "kB", 1000ull }, { "B", 1ull },
+                // accepted when parsing only, an "i" marks a binary unit as in "KiB"
+                { "KB", 1000ull }, { "k", 1000ull }, { "K", 1000ull }, { "M", 1000000ull }, { "G", 1000000000ull }, 
+                { "T", 1000000000000ull }, { "P", 1000000000000000ull }, { "E", 1000000000000000000ull }, 
+                { "Ki", 1ull << 10 }, { "Mi", 1ull << 20 }, { "Gi", 1ull << 30 }, { "Ti", 1ull << 40 }, 
+                { "Pi", 1ull << 50 }, { "Ei", 1ull << 60 }
+            };
+            static const UnitTable table = { units, sizeof(units) / sizeof(units[0]), 13 };
+            return table;
+        }
+
+        inline uint64_t greatestCommonDivisor(uint64_t a, uint64_t b)
+        {
+            while (b != 0) {
+                uint64_t t = a % b;
+                a = b;
+                b = t;
+            }
+            return a;
+        }
+
+        /* Parses a sequence of numbers with units (e.g. "1h30m") into the sum of the numbers in
+         * the canonical unit. A number without unit is accepted on its own only, and for 
+         * durations it must be zero. Overflows and fractions of the canonical unit are rejected.
+         */
+        inline bool parseUnits(const char* token, const UnitTable& table, bool requireUnit, uint64_t& total)
+        {
+            const char* p = token;
+            total = 0;
+            while (*p == ' ') {
+                ++p;
+            }
+            bool first = true;
+            while (*p != '\0') {
+                // number with an optional fraction
+                uint64_t whole = 0;
+                uint64_t fraction = 0;
+                uint64_t scale = 1;
+                bool digits = false;
+                for (; isdigit(static_cast<unsigned char>(*p)); ++p, digits = true) {
+                    const uint64_t digit = static_cast<uint64_t>(*p - '0');
+                    if (whole > (UINT64_MAX - digit) / 10) {
+                        return false;
+                    }
+                    whole = whole * 10 + digit;
+                }
+                if (*p == '.') {
+                    for (++p; isdigit(static_cast<unsigned char>(*p)); ++p, digits = true) {
+                        if (scale >= 1000000000000000000ull) {
+                            return false;
+                        }
+                        fraction = fraction * 10 + static_cast<uint64_t>(*p - '0');
+                        scale *= 10;
+                    }
+                }
+                if (!digits) {
+                    return false;
+                }
+                while (*p == ' ') {
+                    ++p;
+                }
+
+                // unit
+                const char* unit = p;
+                while (*p != '\0' && *p != ' ' && *p != '.' && !isdigit(static_cast<unsigned char>(*p))) {
+                    ++p;
+                }
+                const size_t length = static_cast<size_t>(p - unit);
+                while (*p == ' ') {
+                    ++p;
+                }
+                uint64_t multiplier = 0;
+                if (length == 0) {
+                    if (!first || *p != '\0' || (requireUnit && (whole != 0 || fraction != 0))) {
+                        return false;
+                    }
+                    multiplier = 1;
+                }
+                for (size_t i = 0; i < table.count && multiplier == 0; ++i) {
+                    if (strlen(table.units[i].name) == length && memcmp(table.units[i].name, unit, length) == 0) {
+                        multiplier = table.units[i].multiplier;
+                    }
+                }
+                if (multiplier == 0) {
+                    return false;
+                }
+
+                // fraction * multiplier / scale must be a whole number
+                const uint64_t gcd = greatestCommonDivisor(multiplier, scale);
+                if (fraction % (scale / gcd) != 0) {
+                    return false;
+                }
+                if (whole > UINT64_MAX / multiplier) {
+                    return false;
+                }
+                const uint64_t value = whole * multiplier + (fraction / (scale / gcd)) * (multiplier / gcd);
+                if (value < whole * multiplier || total > UINT64_MAX - value) {
+                    return false;
+                }
+                total += value;
+                first = false;
+            }
+            return !first;
+        }
+
+        // Formats a number in the canonical unit with the largest output unit which represents it exactly
+        inline std::string formatUnits(uint64_t value, const UnitTable& table, bool negative)
+        {
+            const Unit* units = table.units;
+            const size_t count = table.outputCount;
+            size_t u = count - 1;
+            if (value != 0) {
+                for (u = 0; u + 1 < count && value % units[u].multiplier != 0; ++u) {}
+            }
+            char tempStr[32];
+            snprintf(tempStr, sizeof(tempStr), "%s%" PRIu64 "%s", negative ? "-" : "", value / units[u].multiplier, units[u].name);
+            return std::string(tempStr);
+        }
+    }
+
+    MINICONF_INLINE bool Value::parseDuration(const char* token, int64_t& nanoseconds)
+    {
+        while (*token == ' ') {
+            ++token;
+        }
+        const bool negative = (*token == '-');
+        if (*token == '-' || *token == '+') {
+            ++token;
+        }
+        // the magnitude of INT64_MIN is one more than INT64_MAX
+        uint64_t magnitude = 0;
+        const uint64_t limit = static_cast<uint64_t>(INT64_MAX) + (negative ? 1 : 0);
+        if (!detail::parseUnits(token, detail::durationUnits(), true, magnitude) || magnitude > limit) {
+            return false;
+        }
+        nanoseconds = !negative ? static_cast<int64_t>(magnitude) : 
+            (magnitude == 0) ? 0 : -static_cast<int64_t>(magnitude - 1) - 1;
+        return true;
+    }
+
+    MINICONF_INLINE bool Value::parseBytes(const char* token, uint64_t& count)
+    {
+        return detail::parseUnits(token, detail::byteUnits(), false, count);
+    }
+
+    MINICONF_INLINE Value Value::parse(const char* token, DataType type)
+    {
+        if (type == DataType::INT) {
+            int v;
+            int success = sscanf(token, "%d", &v);
+            return (success == 1) ? Value(v) : Value::unknown();
+        }
+        if (type == DataType::NUMBER) {
+            double v;
+            int success = sscanf(token, "%lf", &v);
+            return (success == 1) ? Value(v) : Value();
+
+        }
+        if (type == DataType::BOOL) {
+            std::string v(token);
+            if (v == "false" || v == "False" || v == "FALSE" || v == "F" || v == "f") {
+                return Value(false);
+            }
+            return Value(true);
+
+        }
+        if (type == DataType::STRING || type == DataType::CHOICE) {
+            return Value(token);
+        }
+        if (type == DataType::INT64 || type == DataType::UINT64) {
+            char* end = nullptr;
+            errno = 0;
+            const char* p = token;
+            while (*p == ' ') {
+                ++p;
+            }
+            if (type == DataType::INT64) {
+                long long v = strtoll(p, &end, 10);
+                return (end != p && *end == '\0' && errno == 0) ? Value(static_cast<int64_t>(v)) : Value::unknown();
+            }
+            unsigned long long v = strtoull(p, &end, 10);
+            return (*p != '-' && end != p && *end == '\0' && errno == 0) ? Value(static_cast<uint64_t>(v)) : Value::unknown();
+        }
+        if (type == DataType::DURATION) {
+            int64_t v;
+            return parseDuration(token, v) ? Value::duration(v) : Value::unknown();
+        }
+        if (type == DataType::BYTES) {
+            uint64_t v;
+            return parseBytes(token, v) ? Value::bytes(v) : Value::unknown();
+        }
+        return Value::unknown(); // fool-proof, return an unknown
+    }
+
+#ifndef MINICONF_HAS_TO_CHARS
+    namespace detail
+    {
+        // A floating point number with a 64-bit significand, f * 2^e, used by the Grisu2 algorithm
+        struct DiyFp {
+            uint64_t f;
+            int e;
+        };
+
+        // Multiplies two numbers, the significand of the product is rounded to 64 bits
+        inline DiyFp diyMultiply(const DiyFp& x, const DiyFp& y)
+        {
+            const uint64_t xLo = x.f & 0xFFFFFFFFu, xHi = x.f >> 32;
+            const uint64_t yLo = y.f & 0xFFFFFFFFu, yHi = y.f >> 32;
+            const uint64_t p0 = xLo * yLo, p1 = xLo * yHi, p2 = xHi * yLo, p3 = xHi * yHi;
+            uint64_t q = (p0 >> 32) + (p1 & 0xFFFFFFFFu) + (p2 & 0xFFFFFFFFu);
+            q += 1u << 31;
+            DiyFp product = { p3 + (p1 >> 32) + (p2 >> 32) + (q >> 32), x.e + y.e + 64 };
+            return product;
+        }
+
+        // Shifts a number until the highest bit of its significand is set
+        inline DiyFp diyNormalize(DiyFp x)
+        {
+            while ((x.f >> 63) == 0) {
+                x.f <<= 1;
+                --x.e;
+            }
+            return x;
+        }
+
+        // Normalized powers of ten 10^k = f * 2^e, for k = -300, -292, ..., 340
+        struct CachedPower {
+            uint64_t f;
+            int e;
+            int k;
+        };
+
+        // The cached power of ten for index (300 + k) / 8
+        inline const CachedPower& cachedPower(size_t index)
+        {
+            static const CachedPower powers[] = {
+                { 0xAB70FE17C79AC6CAull, -1060, -300 },
+                { 0xFF77B1FCBEBCDC4Full, -1034, -292 },
+                { 0xBE5691EF416BD60Cull, -1007, -284 },
+                { 0x8DD01FAD907FFC3Cull, -980, -276 },
+                { 0xD3515C2831559A83ull, -954, -268 },
+                { 0x9D71AC8FADA6C9B5ull, -927, -260 },
+                { 0xEA9C227723EE8BCBull, -901, -252 },
+                { 0xAECC49914078536Dull, -874, -244 },
+                { 0x823C12795DB6CE57ull, -847, -236 },
+                { 0xC21094364DFB5637ull, -821, -228 },
+                { 0x9096EA6F3848984Full, -794, -220 },
+                { 0xD77485CB25823AC7ull, -768, -212 },
+                { 0xA086CFCD97BF97F4ull, -741, -204 },
+                { 0xEF340A98172AACE5ull, -715, -196 },
+                { 0xB23867FB2A35B28Eull, -688, -188 },
+                { 0x84C8D4DFD2C63F3Bull, -661, -180 },
+                { 0xC5DD44271AD3CDBAull, -635, -172 },
+                { 0x936B9FCEBB25C996ull, -608, -164 },
+                { 0xDBAC6C247D62A584ull, -582, -156 },
+                { 0xA3AB66580D5FDAF6ull, -555, -148 },
+                { 0xF3E2F893DEC3F126ull, -529, -140 },
+                { 0xB5B5ADA8AAFF80B8ull, -502, -132 },
+                { 0x87625F056C7C4A8Bull, -475, -124 },
+                { 0xC9BCFF6034C13053ull, -449, -116 },
+                { 0x964E858C91BA2655ull, -422, -108 },
+                { 0xDFF9772470297EBDull, -396, -100 },
+                { 0xA6DFBD9FB8E5B88Full, -369, -92 },
+                { 0xF8A95FCF88747D94ull, -343, -84 },
+                { 0xB94470938FA89BCFull, -316, -76 },
+                { 0x8A08F0F8BF0F156Bull, -289, -68 },
+                { 0xCDB02555653131B6ull, -263, -60 },
+                { 0x993FE2C6D07B7FACull, -236, -52 },
+                { 0xE45C10C42A2B3B06ull, -210, -44 },
+                { 0xAA242499697392D3ull, -183, -36 },
+                { 0xFD87B5F28300CA0Eull, -157, -28 },
+                { 0xBCE5086492111AEBull, -130, -20 },
+                { 0x8CBCCC096F5088CCull, -103, -12 },
+                { 0xD1B71758E219652Cull, -77, -4 },
+                { 0x9C40000000000000ull, -50, 4 },
+                { 0xE8D4A51000000000ull, -24, 12 },
+                { 0xAD78EBC5AC620000ull, 3, 20 },
+                { 0x813F3978F8940984ull, 30, 28 },
+                { 0xC097CE7BC90715B3ull, 56, 36 },
+                { 0x8F7E32CE7BEA5C70ull, 83, 44 },
+                { 0xD5D238A4ABE98068ull, 109, 52 },
+                { 0x9F4F2726179A2245ull, 136, 60 },
+                { 0xED63A231D4C4FB27ull, 162, 68 },
+                { 0xB0DE65388CC8ADA8ull, 189, 76 },
+                { 0x83C7088E1AAB65DBull, 216, 84 },
+                { 0xC45D1DF942711D9Aull, 242, 92 },
+                { 0x924D692CA61BE758ull, 269, 100 },
+                { 0xDA01EE641A708DEAull, 295, 108 },
+                { 0xA26DA3999AEF774Aull, 322, 116 },
+                { 0xF209787BB47D6B85ull, 348, 124 },
+                { 0xB454E4A179DD1877ull, 375, 132 },
+                { 0x865B86925B9BC5C2ull, 402, 140 },
+                { 0xC83553C5C8965D3Dull, 428, 148 },
+                { 0x952AB45CFA97A0B3ull, 455, 156 },
+                { 0xDE469FBD99A05FE3ull, 481, 164 },
+                { 0xA59BC234DB398C25ull, 508, 172 },
+                { 0xF6C69A72A3989F5Cull, 534, 180 },
+                { 0xB7DCBF5354E9BECEull, 561, 188 },
+                { 0x88FCF317F22241E2ull, 588, 196 },
+                { 0xCC20CE9BD35C78A5ull, 614, 204 },
+                { 0x98165AF37B2153DFull, 641, 212 },
+                { 0xE2A0B5DC971F303Aull, 667, 220 },
+                { 0xA8D9D1535CE3B396ull, 694, 228 },
+                { 0xFB9B7CD9A4A7443Cull, 720, 236 },
+                { 0xBB764C4CA7A44410ull, 747, 244 },
+                { 0x8BAB8EEFB6409C1Aull, 774, 252 },
+                { 0xD01FEF10A657842Cull, 800, 260 },
+                { 0x9B10A4E5E9913129ull, 827, 268 },
+                { 0xE7109BFBA19C0C9Dull, 853, 276 },
+                { 0xAC2820D9623BF429ull, 880, 284 },
+                { 0x80444B5E7AA7CF85ull, 907, 292 },
+                { 0xBF21E44003ACDD2Dull, 933, 300 },
+                { 0x8E679C2F5E44FF8Full, 960, 308 },
+                { 0xD433179D9C8CB841ull, 986, 316 },
+                { 0x9E19DB92B4E31BA9ull, 1013, 324 },
+                { 0xEB96BF6EBADF77D9ull, 1039, 332 },
+                { 0xAF87023B9BF0EE6Bull, 1066, 340 }
+            };
+            return powers[index];
+        }
+
+        // Moves the last digit closer to the number, as long as it stays within the rounding interval
+        inline void grisuRound(char* digits, int length, uint64_t distance, uint64_t delta, uint64_t rest, uint64_t tenK)
+        {
+            while (rest < distance && delta - rest >= tenK && (rest + tenK < distance || distance - rest > rest + tenK - distance)) {
+                --digits[length - 1];
+                rest += tenK;
+            }
+        }
+
+        // Generates the shortest digits within the scaled rounding interval [minus, plus]
+        inline void grisuDigits(char* digits, int& length, int& exponent, const DiyFp& minus, const DiyFp& w, const DiyFp& plus)
+        {
+            uint64_t delta = plus.f - minus.f;
+            uint64_t distance = plus.f - w.f;
+            const int shift = -plus.e;
+            const uint64_t one = 1ull << shift;
+            uint32_t p1 = static_cast<uint32_t>(plus.f >> shift);
+            uint64_t p2 = plus.f & (one - 1);
+
+            // integral part
+            uint32_t pow10 = 1;
+            int n = 1;
+            while (n < 10 && p1 >= pow10 * 10) {
+                pow10 *= 10;
+                ++n;
+            }
+            while (n > 0) {
+                digits[length++] = static_cast<char>('0' + p1 / pow10);
+                p1 %= pow10;
+                --n;
+                const uint64_t rest = (static_cast<uint64_t>(p1) << shift) + p2;
+                if (rest <= delta) {
+                    exponent += n;
+                    grisuRound(digits, length, distance, delta, rest, static_cast<uint64_t>(pow10) << shift);
+                    return;
+                }
+                pow10 /= 10;
+            }
+
+            // fractional part
+            int m = 0;
+            for (;;) {
+                p2 *= 10;
+                digits[length++] = static_cast<char>('0' + (p2 >> shift));
+                p2 &= one - 1;
+                ++m;
+                delta *= 10;
+                distance *= 10;
+                if (p2 <= delta) {
+                    break;
+                }
+            }
+            exponent -= m;
+            grisuRound(digits, length, distance, delta, p2, one);
+        }
+
+        // Converts a positive finite number into decimal digits and an exponent, value = digits * 10^exponent
+        inline void grisu2(double value, char* digits, int& length, int& exponent)
+        {
+            uint64_t bits = 0;
+            memcpy(&bits, &value, sizeof(bits));
+            const uint64_t fraction = bits & ((1ull << 52) - 1);
+            const int biased = static_cast<int>((bits >> 52) & 0x7FF);
+
+            // boundaries of the rounding interval, halfway to the neighbouring numbers
+            DiyFp v = { (biased == 0) ? fraction : fraction + (1ull << 52), ((biased == 0) ? 1 : biased) - 1075 };
+            const bool lowerCloser = (fraction == 0 && biased > 1);
+            DiyFp plus = { 2 * v.f + 1, v.e - 1 };
+            DiyFp minus = { lowerCloser ? 4 * v.f - 1 : 2 * v.f - 1, lowerCloser ? v.e - 2 : v.e - 1 };
+            plus = diyNormalize(plus);
+            minus.f <<= (minus.e - plus.e);
+            minus.e = plus.e;
+            v = diyNormalize(v);
+
+            // scale by a cached power of ten, so the binary exponent lies in [-60, -32]
+            const int f = -60 - plus.e - 1;
+            const int k = (f * 78913) / (1 << 18) + (f > 0);
+            const CachedPower& cached = cachedPower((300 + k + 7) / 8);
+            const DiyFp c = { cached.f, cached.e };
+            const DiyFp w = diyMultiply(v, c);
+            DiyFp wMinus = diyMultiply(minus, c);
+            DiyFp wPlus = diyMultiply(plus, c);
+            ++wMinus.f;
+            --wPlus.f;
+
+            length = 0;
+            exponent = -cached.k;
+            grisuDigits(digits, length, exponent, wMinus, w, wPlus);
+        }
+
+        // Rounds the digits to one digit fewer, trailing zeros are removed
+        inline void roundDigits(char* digits, int& length, int& exponent)
+        {
+            const bool up = (digits[length - 1] >= '5');
+            --length;
+            ++exponent;
+            if (up) {
+                int i = length - 1;
+                while (i >= 0 && digits[i] == '9') {
+                    --i;
+                }
+                if (i < 0) {
+                    digits[0] = '1';
+                    exponent += length;
+                    length = 1;
+                    return;
+                }
+                ++digits[i];
+                exponent += length - (i + 1);
+                length = i + 1;
+            }
+            while (length > 1 && digits[length - 1] == '0') {
+                --length;
+                ++exponent;
+            }
+        }
+
+        // Checks if digits * 10^exponent parses back to the value, the text has no decimal point so it does not depend on the locale
+        inline bool digitsRoundTrip(const char* digits, int length, int exponent, double value)
+        {
+            char text[NUMBER_BUFFER_SIZE + 8];
+            memcpy(text, digits, length);
+            snprintf(text + length, 8, "e%d", exponent);
+            return strtod(text, nullptr) == value;
+        }
+
+        // Writes digits * 10^exponent in the shorter of fixed and scientific notation, fixed notation is preferred on a tie
+        inline size_t formatDigits(char* buffer, bool negative, const char* digits, int length, int exponent)
+        {
+            char* p = buffer;
+            if (negative) {
+                *p++ = '-';
+            }
+            const int point = length + exponent;
+            const int scientific = point - 1;
+            const int magnitude = (scientific < 0) ? -scientific : scientific;
+            const int scientificLength = length + ((length > 1) ? 1 : 0) + 2 + ((magnitude >= 100) ? 3 : 2);
+            const int fixedLength = (point >= length) ? point : (point > 0) ? length + 1 : 2 - point + length;
+            if (fixedLength <= scientificLength) {
+                if (point >= length) {
+                    memcpy(p, digits, length);
+                    memset(p + length, '0', point - length);
+                    p += point;
+                } else if (point > 0) {
+                    memcpy(p, digits, point);
+                    p += point;
+                    *p++ = '.';
+                    memcpy(p, digits + point, length - point);
+                    p += length - point;
+                } else {
+                    *p++ = '0';
+                    *p++ = '.';
+                    memset(p, '0', -point);
+                    p += -point;
+                    memcpy(p, digits, length);
+                    p += length;
+                }
+            } else {
+                *p++ = digits[0];
+                if (length > 1) {
+                    *p++ = '.';
+                    memcpy(p, digits + 1, length - 1);
+                    p += length - 1;
+                }
+                *p++ = 'e';
+                *p++ = (scientific < 0) ? '-' : '+';
+                if (magnitude >= 100) {
+                    *p++ = static_cast<char>('0' + magnitude / 100);
+                }
+                *p++ = static_cast<char>('0' + (magnitude / 10) % 10);
+                *p++ = static_cast<char>('0' + magnitude % 10);
+            }
+            *p = '\0';
+            return static_cast<size_t>(p - buffer);
+        }
+    }
+#endif
+
+    // number formatting
+    MINICONF_INLINE size_t formatNumber(double value, char* buffer)
+    {
+        if (std::isnan(value) || std::isinf(value)) {
+            return static_cast<size_t>(snprintf(buffer, NUMBER_BUFFER_SIZE, "%s", std::isnan(value) ? "nan" : (value < 0) ? "-inf" : "inf"));
+        }
+        double integral = 0.0;
+        const bool fixed = (fabs(value) < 9007199254740992.0 && modf(value, &integral) == 0.0);
+#ifdef MINICONF_HAS_TO_CHARS
+        // shortest round-trip representation from the standard library
+        std::to_chars_result result = fixed ? 
+            std::to_chars(buffer, buffer + NUMBER_BUFFER_SIZE - 1, value, std::chars_format::fixed) :
+            std::to_chars(buffer, buffer + NUMBER_BUFFER_SIZE - 1, value);
+        *result.ptr = '\0';
+        return static_cast<size_t>(result.ptr - buffer);
+#else
+        const bool negative = std::signbit(value);
+        if (fixed) {
+            // integers are written digit by digit
+            char digits[NUMBER_BUFFER_SIZE];
+            int length = 0;
+            uint64_t n = static_cast<uint64_t>(fabs(value));
+            do {
+                digits[length++] = static_cast<char>('0' + n % 10);
+                n /= 10;
+            } while (n != 0);
+            std::reverse(digits, digits + length);
+            return detail::formatDigits(buffer, negative, digits, length, 0);
+        }
+        char digits[NUMBER_BUFFER_SIZE];
+        int length = 0;
+        int exponent = 0;
+        detail::grisu2(fabs(value), digits, length, exponent);
+        // Grisu2 may miss the shortest digits of a number, which shows up as a long result with
+        // a run of zeros or nines before the last digit, shorter candidates of those are verified
+        char shorter[NUMBER_BUFFER_SIZE];
+        while (length > 15 && digits[length - 2] == digits[length - 3] && (digits[length - 2] == '0' || digits[length - 2] == '9')) {
+            int shorterLength = length;
+            int shorterExponent = exponent;
+            memcpy(shorter, digits, length);
+            detail::roundDigits(shorter, shorterLength, shorterExponent);
+            if (!detail::digitsRoundTrip(shorter, shorterLength, shorterExponent, fabs(value))) {
+                break;
+            }
+            memcpy(digits, shorter, shorterLength);
+            length = shorterLength;
+            exponent = shorterExponent;
+        }
+        return detail::formatDigits(buffer, negative, digits, length, exponent);
+#endif
+    }
+
+#ifdef PICOJSON_NUMBER_TO_STR
+    MINICONF_INLINE std::string formatNumberString(double value)
+    {
+        char buffer[NUMBER_BUFFER_SIZE];
+        return std::string(buffer, formatNumber(value, buffer));
+    }
+#endif
+
+    //  char array
+    MINICONF_INLINE Value::Value(const char* other) : Value()
+    {
+        copyData(other, strlen(other) + 1, DataType::STRING);
+    }
+
+    MINICONF_INLINE Value& Value::operator=(const char* other)
+    {
+        clearData();
+        return copyData(other, strlen(other) + 1, DataType::STRING);
+    }
+
+    MINICONF_INLINE Value::operator const char*() const
+    {
+        return reinterpret_cast<const char*>(_data);
+    }
+
+    MINICONF_INLINE const char* Value::getCharArray() const
+    {
+        return reinterpret_cast<const char*>(_data);
+    }
+
+    //  std::string
+    MINICONF_INLINE Value::Value(const std::string& other) : Value()
+    {
+        copyData(other.c_str(), other.size() + 1, DataType::STRING);
+    }
+
+    MINICONF_INLINE Value& Value::operator=(const std::string& other)
+    {
+        clearData();
+        return copyData(other.c_str(), other.size() + 1, DataType::STRING);
+    }
+
+#ifdef MINICONF_HAS_STRING_VIEW
+    MINICONF_INLINE Value::Value(std::string_view other) : Value()
+    {
+        // a view is not null terminated, the terminator is written after the copied characters
+        _type = DataType::STRING;
+        _size = other.size() + 1;
+        char* data = allocData(_size);
+        memcpy(data, other.data(), other.size());
+        data[other.size()] = '\0';
+    }
+#endif
+
+    MINICONF_INLINE Value::operator std::string() const
+    {
+        return getString();
+    }
+
+    MINICONF_INLINE std::string Value::getString() const
+    {
+        return std::string(reinterpret_cast<char*>(_data), length());
+    }
+
+#ifdef MINICONF_HAS_STRING_VIEW
+    MINICONF_INLINE Value::operator std::string_view() const
+    {
+        return getStringView();
+    }
+
+    MINICONF_INLINE std::string_view Value::getStringView() const
+    {
+        return std::string_view(reinterpret_cast<char*>(_data), length());
+    }
+#endif
+
+    MINICONF_INLINE size_t Value::length() const
+    {
+        // the buffer of a string includes its null terminator, the name of a choice is followed by its code
+        if (_type == DataType::CHOICE) {
+            return _size - 1 - sizeof(int32_t);
+        }
+        return (_type == DataType::STRING && _size > 0) ? _size - 1 : 0;
+    }
+
+    // print function
+    MINICONF_INLINE std::string Value::print() const
+    {
+        const int slen = 31;
+        char tempStr[slen + 1];
+        std::string outStr;
+        switch (_type) {
+            case DataType::UNKNOWN:
+                snprintf(tempStr, slen, "null");
+                break;
+            case DataType::INT:
+                snprintf(tempStr, slen, "%d", getInt());
+                outStr = std::string(tempStr);
+                break;
+            case DataType::NUMBER:
+                outStr = std::string(tempStr, formatNumber(getNumber(), tempStr));
+                break;
+            case DataType::BOOL:
+                snprintf(tempStr, slen, "%s", getBoolean() ? "true" : "false");
+                outStr = std::string(tempStr);
+                break;
+            case DataType::STRING:
+            case DataType::CHOICE:
+                outStr = "\"" + getString() + "\"";
+                break;
+            case DataType::INT64:
+                snprintf(tempStr, slen, "%" PRId64, getInt64());
+                outStr = std::string(tempStr);
+                break;
+            case DataType::UINT64:
+                snprintf(tempStr, slen, "%" PRIu64, getUInt64());
+                outStr = std::string(tempStr);
+                break;
+            case DataType::DURATION:
+                outStr = detail::formatUnits((getDuration() < 0) ? 0 - static_cast<uint64_t>(getDuration()) : static_cast<uint64_t>(getDuration()), 
+                    detail::durationUnits(), getDuration() < 0);
+                break;
+            case DataType::BYTES:
+                outStr = detail::formatUnits(getBytes(), detail::byteUnits(), false);
+                break;
+            default:
+                break;
+        }
+        return outStr;
+    }
+
+    // return data type
+    MINICONF_INLINE Value::DataType Value::type() const
+    {
+        return _type;
+    }
+
+    // check empty
+    MINICONF_INLINE bool Value::isEmpty() const
+    {
+        return (_data == nullptr || _type == DataType::UNKNOWN);
+    }
+
+    // generate unknown value
+    MINICONF_INLINE Value Value::unknown()
+    {
+        return Value();
+    }
+
+    // print value data type
+    MINICONF_INLINE std::string Value::printType() const
+    {
+        std::string outStr;
+        const int slen = 15;
+        char tempStr[slen + 1];
+        switch (_type) {
+            case DataType::UNKNOWN:
+                snprintf(tempStr, slen, "UNKNOWN");
+                break;
+            case DataType::INT:
+                snprintf(tempStr, slen, "INT");
+                break;
+            case DataType::NUMBER:
+                snprintf(tempStr, slen, "NUMBER");
+                break;
+            case DataType::BOOL:
+                snprintf(tempStr, slen, "BOOLEAN");
+                break;
+            case DataType::STRING:
+                snprintf(tempStr, slen, "STRING");
+                break;
+            case DataType::INT64:
+                snprintf(tempStr, slen, "INT64");
+                break;
+            case DataType::UINT64:
+                snprintf(tempStr, slen, "UINT64");
+                break;
+            case DataType::DURATION:
+                snprintf(tempStr, slen, "DURATION");
+                break;
+            case DataType::BYTES:
+                snprintf(tempStr, slen, "BYTES");
+                break;
+            case DataType::CHOICE:
+                snprintf(tempStr, slen, "CHOICE");
+                break;
+            default:
+                break;
+        }
+        return std::string(tempStr);
+    }
+
+    // internal use
+    MINICONF_INLINE Value::SharedBuffer* Value::sharedBuffer() const
+    {
+        return reinterpret_cast<SharedBuffer*>(_data - sizeof(SharedBuffer));
+    }
+
+    // share function
+    MINICONF_INLINE Value& Value::shareData(const Value& other)
+    {
+        if (other._data == nullptr || other._data == other._inline) {
+            return copyData(other._data, other._size, other._type);
+        }
+        other.sharedBuffer()->refs.fetch_add(1, std::memory_order_relaxed);
+        _type = other._type;
+        _size = other._size;
+        _data = other._data;
+        return *this;
+    }
+
+    // move and copy function
+    MINICONF_INLINE Value& Value::moveData(Value& other)
+    {
+        if (other._data == other._inline) {
+            copyData(other._data, other._size, other._type);
+        } else {
+            _type = other._type;
+            _size = other._size;
+            _data = other._data;
+        }
+        other._type = DataType::UNKNOWN;
+        other._size = 0;
+        other._data = nullptr;
+        return *this;
+    }
+
+    // internal use
+    MINICONF_INLINE Value& Value::copyData(const char* src, const size_t size, const DataType& type)
+    {
+        _type = type;
+        _size = size;
+        _data = nullptr;
+        if (src != nullptr && size != 0) {
+            memcpy(allocData(size), src, size);
+        }
+        return *this;
+    }
+
+    // internal use
+    MINICONF_INLINE char* Value::allocData(const size_t size)
+    {
+        if (size <= sizeof(_inline)) {
+            _data = _inline;
+        } else {
+            // the header is placed before the value data
+            char* buffer = new char[sizeof(SharedBuffer) + size];
+            new (buffer) SharedBuffer();
+            reinterpret_cast<SharedBuffer*>(buffer)->refs.store(1, std::memory_order_relaxed);
+            _data = buffer + sizeof(SharedBuffer);
+        }
+        return _data;
+    }
+
+    // internal use
+    MINICONF_INLINE void Value::clearData()
+    {
+        if (_data != nullptr && _data != _inline) {
+            // the last reference releases the buffer
+            if (sharedBuffer()->refs.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+                delete[] (_data - sizeof(SharedBuffer));
+            }
+        }
+        _type = DataType::UNKNOWN;
+        _size = 0;
+        _data = nullptr;
+    }
+
+    // Choices
+    MINICONF_INLINE Config::Choices::Choices(const std::vector<std::string>& names)
+    {
+        for (auto && name : names) {
+            if (std::find(_names.begin(), _names.end(), name) == _names.end()) {
+                _values.push_back(Value::choice(static_cast<int>(_names.size()), name.c_str()));
+                _names.push_back(name);
+            }
+        }
+        if (!buildHash()) {
+            _displacements.clear();
+        }
+    }
+
+    MINICONF_INLINE int Config::Choices::find(const char* name, size_t length) const
+    {
+        const size_t n = _names.size();
+        if (_displacements.empty()) {
+            for (size_t code = 0; code < n; ++code) {
+                if (_names[code].size() == length && memcmp(_names[code].data(), name, length) == 0) {
+                    return static_cast<int>(code);
+                }
+            }
+            return -1;
+        }
+        // one probe, the candidate is compared to reject names which are not allowed
+        uint32_t d = _displacements[FlagTable::hash(name, length, 0) % n];
+        int code = _slots[FlagTable::hash(name, length, d) % n];
+        if (code >= 0 && _names[code].size() == length && memcmp(_names[code].data(), name, length) == 0) {
+            return code;
+        }
+        return -1;
+    }
+
+    MINICONF_INLINE const char* Config::Choices::name(int code) const
+    {
+        return _names[code].c_str();
+    }
+
+    MINICONF_INLINE const Value& Config::Choices::value(int code) const
+    {
+        return _values[code];
+    }
+
+    MINICONF_INLINE size_t Config::Choices::size() const
+    {
+        return _names.size();
+    }
+
+    MINICONF_INLINE std::string Config::Choices::list() const
+    {
+        std::string out;
+        for (size_t code = 0; code < _names.size(); ++code) {
+            out += (code == 0) ? "" : ", ";
+            out += _names[code];
+        }
+        return out;
+    }
+
+    MINICONF_INLINE bool Config::Choices::buildHash()
+    {
+        // the same displacement scheme as the flag tables of miniconf_schemagen
+        const size_t n = _names.size();
+        _displacements.assign(n, 0);
+        _slots.assign(n, -1);
+        std::vector<std::vector<size_t>> buckets(n);
+        for (size_t i = 0; i < n; ++i) {
+            buckets[FlagTable::hash(_names[i].data(), _names[i].size(), 0) % n].push_back(i);
+        }
+        std::vector<size_t> order(n);
+        for (size_t b = 0; b < n; ++b) {
+            order[b] = b;
+        }
+        std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+            return buckets[a].size() > buckets[b].size();
+        });
+        std::vector<size_t> taken;
+        for (size_t b : order) {
+            if (buckets[b].empty()) {
+                break;
+            }
+            bool placed = false;
+            for (uint32_t d = 1; d < (1u << 20) && !placed; ++d) {
+                taken.clear();
+                placed = true;
+                for (size_t k : buckets[b]) {
+                    size_t slot = FlagTable::hash(_names[k].data(), _names[k].size(), d) % n;
+                    if (_slots[slot] >= 0 || std::find(taken.begin(), taken.end(), slot) != taken.end()) {
+                        placed = false;
+                        break;
+                    }
+                    taken.push_back(slot);
+                }
+                if (placed) {
+                    for (size_t i = 0; i < taken.size(); ++i) {
+                        _slots[taken[i]] = static_cast<int>(buckets[b][i]);
+                    }
+                    _displacements[b] = d;
+                }
+            }
+            if (!placed) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // Option
+    MINICONF_INLINE Config::Option::Option() : _owner(nullptr), _row(0)
+    {}
+
+    MINICONF_INLINE Config::Option::Option(const Option& other) : _owner(nullptr), _row(0)
+    {
+        assign(other.definition());
+    }
+
+    MINICONF_INLINE Config::Option::Option(Option&& other) : _owner(nullptr), _row(0)
+    {
+        // an option stored in a table is copied, it is not taken out of the table
+        if (other._owner) {
+            assign(other.definition());
+        } else {
+            _definition = std::move(other._definition);
+        }
+    }
+
+    MINICONF_INLINE Config::Option& Config::Option::operator=(const Option& other)
+    {
+        if (this != &other) {
+            assign(other.definition());
+        }
+        return *this;
+    }
+
+    MINICONF_INLINE Config::Option& Config::Option::operator=(Option&& other)
+    {
+        if (this != &other) {
+            if (_owner || other._owner) {
+                assign(other.definition());
+            } else {
+                _definition = std::move(other._definition);
+            }
+        }
+        return *this;
+    }
+
+    MINICONF_INLINE Config::Option::~Option()
+    {}
+
+    MINICONF_INLINE Config::Option& Config::Option::flag(const std::string& flag)
+    {
+        if (_owner) {
+            mutableTable().flag(_row, flag.data(), flag.size());
+        } else {
+            mutableDetached().flag = flag;
+        }
+        return *this;
+    }
+
+    MINICONF_INLINE Config::Option& Config::Option::flag(std::string&& flag)
+    {
+        if (_owner) {
+            mutableTable().flag(_row, flag.data(), flag.size());
+        } else {
+            mutableDetached().flag = std::move(flag);
+        }
+        return *this;
+    }
+
+    MINICONF_INLINE Config::Option& Config::Option::shortflag(const std::string& shortflag)
+    {
+        if (_owner) {
+            mutableTable().shortflag(_row, shortflag.data(), shortflag.size());
+        } else {
+            mutableDetached().shortflag = shortflag;
+        }
+        return *this;
+    }
+
+    MINICONF_INLINE Config::Option& Config::Option::shortflag(std::string&& shortflag)
+    {
+        if (_owner) {
+            mutableTable().shortflag(_row, shortflag.data(), shortflag.size());
+        } else {
+            mutableDetached().shortflag = std::move(shortflag);
+        }
+        return *this;
+    }
+
+    MINICONF_INLINE Config::Option& Config::Option::description(const std::string& description)
+    {
+        if (_owner) {
+            mutableTable().description(_row, description.data(), description.size());
+        } else {
+            mutableDetached().description = description;
+        }
+        return *this;
+    }
+
+    MINICONF_INLINE Config::Option& Config::Option::description(std::string&& description)
+    {
+        if (_owner) {
+            mutableTable().description(_row, description.data(), description.size());
+        } else {
+            mutableDetached().description = std::move(description);
+        }
+        return *this;
+    }
+
+    MINICONF_INLINE Config::Option& Config::Option::description(const char* description)
+    {
+        if (_owner) {
+            mutableTable().description(_row, description, strlen(description));
+        } else {
+            mutableDetached().description = description;
+        }
+        return *this;
+    }
+
+#ifdef MINICONF_HAS_STRING_VIEW
+    MINICONF_INLINE Config::Option& Config::Option::description(std::string_view description)
+    {
+        if (_owner) {
+            mutableTable().description(_row, description.data(), description.size());
+        } else {
+            mutableDetached().description.assign(description.data(), description.size());
+        }
+        return *this;
+    }
+#endif
+
+    MINICONF_INLINE Config::Option& Config::Option::defaultValue(const Value& defaultValue)
+    {
+        return this->defaultValue(Value(defaultValue));
+    }
+
+    MINICONF_INLINE Config::Option& Config::Option::defaultValue(Value&& defaultValue)
+    {
+        if (_owner) {
+            mutableTable().defaultValue(_row, std::move(defaultValue));
+        } else {
+            mutableDetached().defaultValue = std::move(defaultValue);
+        }
+        return *this;
+    }
+
+    MINICONF_INLINE Config::Option& Config::Option::defaultValue(const int& defaultValue)
+    {
+        return this->defaultValue(Value(static_cast<int>(defaultValue)));
+    }
+
+    MINICONF_INLINE Config::Option& Config::Option::defaultValue(const double& defaultValue)
+    {
+        return this->defaultValue(Value(static_cast<double>(defaultValue)));
+    }
+
+    MINICONF_INLINE Config::Option& Config::Option::defaultValue(const bool& defaultValue)
+    {
+        return this->defaultValue(Value(static_cast<bool>(defaultValue)));
+    }
+
+    MINICONF_INLINE Config::Option& Config::Option::defaultValue(const int64_t& defaultValue)
+    {
+        return this->defaultValue(Value(defaultValue));
+    }
+
+    MINICONF_INLINE Config::Option& Config::Option::defaultValue(const uint64_t& defaultValue)
+    {
+        return this->defaultValue(Value(defaultValue));
+    }
+
+    MINICONF_INLINE Config::Option& Config::Option::defaultValue(const char* defaultValue)
+    {
+        return this->defaultValue(Value(defaultValue));
+    }
+
+    MINICONF_INLINE Config::Option& Config::Option::defaultValue(const std::string& defaultValue)
+    {
+        return this->defaultValue(Value(defaultValue));
+    }
+
+#ifdef MINICONF_HAS_STRING_VIEW
+    MINICONF_INLINE Config::Option& Config::Option::defaultValue(std::string_view defaultValue)
+    {
+        return this->defaultValue(Value(defaultValue));
+    }
+#endif
+
+    MINICONF_INLINE Config::Option& Config::Option::required(const bool required)
+    {
+        if (_owner) {
+            mutableTable().required(_row, required);
+        } else {
+            mutableDetached().required = required;
+        }
+        return *this;
+    }
+
+    MINICONF_INLINE Config::Option& Config::Option::hidden(const bool hidden)
+    {
+        if (_owner) {
+            mutableTable().hidden(_row, hidden);
+        } else {
+            mutableDetached().hidden = hidden;
+        }
+        return *this;
+    }
+
+    MINICONF_INLINE Config::Option& Config::Option::choices(const std::vector<std::string>& names)
+    {
+        std::shared_ptr<const Choices> choices = std::make_shared<Choices>(names);
+        if (_owner) {
+            mutableTable().choices(_row, std::move(choices));
+        } else {
+            mutableDetached().choices = std::move(choices);
+        }
+        return *this;
+    }
+
+    MINICONF_INLINE Config::Option& Config::Option::range(const Value& minimum, const Value& maximum)
+    {
+        std::shared_ptr<Constraints> constraints = copyConstraints();
+        constraints->minimum = minimum;
+        constraints->maximum = maximum;
+        return this->constraints(std::move(constraints));
+    }
+
+    MINICONF_INLINE Config::Option& Config::Option::range(double minimum, double maximum)
+    {
+        return range(Value(minimum), Value(maximum));
+    }
+
+    MINICONF_INLINE Config::Option& Config::Option::length(size_t minimum, size_t maximum)
+    {
+        std::shared_ptr<Constraints> constraints = copyConstraints();
+        constraints->minLength = minimum;
+        constraints->maxLength = maximum;
+        return this->constraints(std::move(constraints));
+    }
+
+#ifndef MINICONF_LEAN
+    MINICONF_INLINE Config::Option& Config::Option::pattern(const std::string& pattern)
+    {
+        std::shared_ptr<Constraints> constraints = copyConstraints();
+        constraints->pattern = pattern;
+        constraints->regex.reset();
+        if (!pattern.empty()) {
+            // an invalid pattern leaves the regex empty, which is reported by checkFormat()
+            try {
+                constraints->regex = std::make_shared<std::regex>(pattern, std::regex::ECMAScript | std::regex::optimize);
+            } catch (const std::regex_error&) {
+            }
+        }
+        return this->constraints(std::move(constraints));
+    }
+#endif
+
+    MINICONF_INLINE std::shared_ptr<Config::Constraints> Config::Option::copyConstraints() const
+    {
+        std::shared_ptr<const Constraints> current = constraints();
+        return current ? std::make_shared<Constraints>(*current) : std::make_shared<Constraints>();
+    }
+
+    MINICONF_INLINE Config::Option& Config::Option::constraints(std::shared_ptr<const Constraints> constraints)
+    {
+        if (_owner) {
+            mutableTable().constraints(_row, std::move(constraints));
+        } else {
+            mutableDetached().constraints = std::move(constraints);
+        }
+        return *this;
+    }
+
+    MINICONF_INLINE std::string Config::Option::flag() const
+    {
+        return _owner ? std::string(table().flag(_row)) : detached().flag;
+    }
+
+    MINICONF_INLINE std::string Config::Option::shortflag() const
+    {
+        return _owner ? std::string(table().shortflag(_row)) : detached().shortflag;
+    }
+
+    MINICONF_INLINE std::string Config::Option::description() const
+    {
+        return _owner ? std::string(table().description(_row)) : detached().description;
+    }
+
+#ifdef MINICONF_HAS_STRING_VIEW
+    MINICONF_INLINE std::string_view Config::Option::flagView() const
+    {
+        return _owner ? std::string_view(table().flag(_row)) : std::string_view(detached().flag);
+    }
+
+    MINICONF_INLINE std::string_view Config::Option::shortflagView() const
+    {
+        return _owner ? std::string_view(table().shortflag(_row)) : std::string_view(detached().shortflag);
+    }
+
+    MINICONF_INLINE std::string_view Config::Option::descriptionView() const
+    {
+        return _owner ? std::string_view(table().description(_row)) : std::string_view(detached().description);
+    }
+#endif
+
+    MINICONF_INLINE const Value& Config::Option::defaultValue() const
+    {
+        return _owner ? table().defaultValue(_row) : detached().defaultValue;
+    }
+
+    MINICONF_INLINE bool Config::Option::required() const
+    {
+        return _owner ? table().required(_row) : detached().required;
+    }
+
+    MINICONF_INLINE bool Config::Option::hidden() const
+    {
+        return _owner ? table().hidden(_row) : detached().hidden;
+    }
+
+    MINICONF_INLINE Value::DataType Config::Option::type() const
+    {
+        if (_owner) {
+            return table().type(_row);
+        }
+        return detached().choices ? Value::DataType::CHOICE : detached().defaultValue.type();
+    }
+
+    MINICONF_INLINE std::shared_ptr<const Config::Choices> Config::Option::choices() const
+    {
+        return _owner ? table().choices(_row) : detached().choices;
+    }
+
+    MINICONF_INLINE std::shared_ptr<const Config::Constraints> Config::Option::constraints() const
+    {
+        return _owner ? table().constraints(_row) : detached().constraints;
+    }
+
+    MINICONF_INLINE Config::Option::Definition Config::Option::definition() const
+    {
+        if (!_owner) {
+            return detached();
+        }
+        const OptionTable& table = this->table();
+        Definition d = {table.flag(_row), table.shortflag(_row), table.description(_row), 
+            table.defaultValue(_row), table.required(_row), table.hidden(_row), table.choices(_row), 
+            table.constraints(_row)};
+        return d;
+    }
+
+    MINICONF_INLINE void Config::Option::assign(const Definition& definition)
+    {
+        if (!_owner) {
+            mutableDetached() = definition;
+            return;
+        }
+        OptionTable& table = mutableTable();
+        table.flag(_row, definition.flag.data(), definition.flag.size());
+        table.shortflag(_row, definition.shortflag.data(), definition.shortflag.size());
+        table.description(_row, definition.description.data(), definition.description.size());
+        table.choices(_row, definition.choices);
+        table.constraints(_row, definition.constraints);
+        table.defaultValue(_row, Value(definition.defaultValue));
+        table.required(_row, definition.required);
+        table.hidden(_row, definition.hidden);
+    }
+
+    MINICONF_INLINE const Config::OptionTable& Config::Option::table() const
+    {
+        return *(_owner->_options);
+    }
+
+    MINICONF_INLINE Config::OptionTable& Config::Option::mutableTable()
+    {
+        // the table is split first if it is shared with copies of the Config object
+        return _owner->mutableOptions();
+    }
+
+    MINICONF_INLINE const Config::Option::Definition& Config::Option::detached() const
+    {
+        static const Definition empty = {"", "", "", Value::unknown(), false, false, nullptr, nullptr};
+        return _definition ? *_definition : empty;
+    }
+
+    MINICONF_INLINE Config::Option::Definition& Config::Option::mutableDetached()
+    {
+        if (!_definition) {
+            _definition.reset(new Definition{"", "", "", Value::unknown(), false, false, nullptr, nullptr});
+        }
+        return *_definition;
+    }
+
+    // OptionHandles
+    MINICONF_INLINE Config::OptionHandles::OptionHandles()
+    {}
+
+    MINICONF_INLINE Config::OptionHandles::OptionHandles(const OptionHandles&)
+    {}
+
+    MINICONF_INLINE Config::OptionHandles& Config::OptionHandles::operator=(const OptionHandles& other)
+    {
+        if (this != &other) {
+            options.clear();
+        }
+        return *this;
+    }
+
+    // JournalHandle
+    MINICONF_INLINE Config::JournalHandle::JournalHandle()
+    {}
+
+    MINICONF_INLINE Config::JournalHandle::JournalHandle(const JournalHandle&)
+    {}
+
+    MINICONF_INLINE Config::JournalHandle& Config::JournalHandle::operator=(const JournalHandle& other)
+    {
+        if (this != &other) {
+            journal.reset();
+        }
+        return *this;
+    }
+
+    // OptionTable
+    MINICONF_INLINE Config::OptionTable::OptionTable() : _pool(1, '\0'), _garbage(0), _size(0)
+    {}
+
+    MINICONF_INLINE Config::OptionTable::OptionTable(const OptionTable& other) : OptionTable(other, true)
+    {}
+
+    MINICONF_INLINE Config::OptionTable::OptionTable(const OptionTable& other, bool compact) : _pool(1, '\0'), _garbage(0), _size(0)
+    {
+        if (!compact) {
+            _hashes = other._hashes;
+            _defaultValues = other._defaultValues;
+            _bits = other._bits;
+            _strings = other._strings;
+            _pool = other._pool;
+            _garbage = other._garbage;
+            _choices = other._choices;
+            _constraints = other._constraints;
+            _groups = other._groups;
+            _index = other._index;
+            _shortflagIndex = other._shortflagIndex;
+            _size = other._size;
+            return;
+        }
+        _hashes.reserve(other._size);
+        _defaultValues.reserve(other._size);
+        _bits.reserve(other._size);
+        _strings.reserve(other._size);
+        // rows of the groups are renumbered when the removed rows are dropped
+        std::vector<uint32_t> renumbered(other._groups.empty() ? 0 : other.rows(), static_cast<uint32_t>(NONE));
+        for (uint32_t row = 0; row < other.rows(); ++row) {
+            if (other.removed(row)) {
+                continue;
+            }
+            const char* text[3] = {other.flag(row), other.shortflag(row), other.description(row)};
+            _hashes.push_back(other._hashes[row]);
+            _defaultValues.push_back(other._defaultValues[row]);
+            _bits.push_back(other._bits[row]);
+            _strings.push_back(Strings{pool(text[0], strlen(text[0])), pool(text[1], strlen(text[1])), 0});
+            description(static_cast<uint32_t>(_strings.size() - 1), text[2], strlen(text[2]));
+            auto found = other._choices.find(row);
+            if (found != other._choices.end()) {
+                _choices[static_cast<uint32_t>(_strings.size() - 1)] = found->second;
+            }
+            auto constraints = other._constraints.find(row);
+            if (constraints != other._constraints.end()) {
+                _constraints[static_cast<uint32_t>(_strings.size() - 1)] = constraints->second;
+            }
+            if (!renumbered.empty()) {
+                renumbered[row] = static_cast<uint32_t>(_strings.size() - 1);
+            }
+        }
+        for (auto && g : other._groups) {
+            std::vector<uint32_t> rows;
+            for (auto && row : g) {
+                if (renumbered[row] != NONE) {
+                    rows.push_back(renumbered[row]);
+                }
+            }
+            group(std::move(rows));
+        }
+        _size = _hashes.size();
+        rebuildIndex(_size);
+    }
+
+    MINICONF_INLINE size_t Config::OptionTable::rows() const
+    {
+        return _hashes.size();
+    }
+
+    MINICONF_INLINE void Config::OptionTable::reserve(size_t count)
+    {
+        _hashes.reserve(count);
+        _defaultValues.reserve(count);
+        _bits.reserve(count);
+        _strings.reserve(count);
+        // the indexes are rebuilt once instead of doubling while the rows are inserted
+        if (count * 2 > _index.size()) {
+            rebuildIndex(count);
+        }
+    }
+
+    MINICONF_INLINE uint32_t Config::OptionTable::find(const char* flag, size_t length) const
+    {
+        if (_index.empty()) {
+            return NONE;
+        }
+        uint32_t hash = FlagTable::hash(flag, length, 0);
+        size_t mask = _index.size() - 1;
+        for (size_t slot = hash & mask; _index[slot] != NONE; slot = (slot + 1) & mask) {
+            uint32_t row = _index[slot];
+            if (_hashes[row] == hash && equals(_strings[row].flag, flag, length)) {
+                return row;
+            }
+        }
+        return NONE;
+    }
+
+    MINICONF_INLINE uint32_t Config::OptionTable::findShortflag(const char* shortflag, size_t length) const
+    {
+        if (_shortflagIndex.empty() || length == 0) {
+            return NONE;
+        }
+        size_t mask = _shortflagIndex.size() - 1;
+        for (size_t slot = FlagTable::hash(shortflag, length, 1) & mask; _shortflagIndex[slot] != NONE; slot = (slot + 1) & mask) {
+            uint32_t row = _shortflagIndex[slot];
+            if (equals(_strings[row].shortflag, shortflag, length)) {
+                return row;
+            }
+        }
+        return NONE;
+    }
+
+    MINICONF_INLINE uint32_t Config::OptionTable::insert(const char* flag, size_t length)
+    {
+        uint32_t row = find(flag, length);
+        if (row != NONE) {
+            return row;
+        }
+        row = static_cast<uint32_t>(rows());
+        _hashes.push_back(FlagTable::hash(flag, length, 0));
+        _defaultValues.emplace_back();
+        _bits.push_back(0);
+        _strings.push_back(Strings{pool(flag, length), 0, 0});
+        ++_size;
+        index(row);
+        return row;
+    }
+
+    MINICONF_INLINE void Config::OptionTable::remove(uint32_t row)
+    {
+        if (row < rows() && !removed(row)) {
+            unindexFlag(row);
+            unindexShortflag(row);
+            _bits[row] = REMOVED;
+            _defaultValues[row] = Value();
+            _choices.erase(row);
+            _constraints.erase(row);
+            --_size;
+            release(_strings[row].flag);
+            release(_strings[row].shortflag);
+            if ((row == 0 || _strings[row - 1].description != _strings[row].description) && 
+                (row + 1 == rows() || _strings[row + 1].description != _strings[row].description)) {
+                release(_strings[row].description);
+            }
+            _strings[row] = Strings{0, 0, 0};
+            compactPool();
+        }
+    }
+
+    MINICONF_INLINE std::vector<uint32_t> Config::OptionTable::sorted() const
+    {
+        std::vector<uint32_t> result;
+        result.reserve(_size);
+        for (uint32_t row = 0; row < rows(); ++row) {
+            if (!removed(row)) {
+                result.push_back(row);
+            }
+        }
+        std::sort(result.begin(), result.end(), [this](uint32_t a, uint32_t b) {
+            return strcmp(flag(a), flag(b)) < 0;
+        });
+        return result;
+    }
+
+    MINICONF_INLINE bool Config::OptionTable::removed(uint32_t row) const
+    {
+        return (_bits[row] & REMOVED) != 0;
+    }
+
+    MINICONF_INLINE bool Config::OptionTable::required(uint32_t row) const
+    {
+        return (_bits[row] & REQUIRED) != 0;
+    }
+
+    MINICONF_INLINE bool Config::OptionTable::hidden(uint32_t row) const
+    {
+        return (_bits[row] & HIDDEN) != 0;
+    }
+
+    MINICONF_INLINE bool Config::OptionTable::duplicateShortflag(uint32_t row) const
+    {
+        return (_bits[row] & DUPLICATE_SHORTFLAG) != 0;
+    }
+
+    MINICONF_INLINE const Value& Config::OptionTable::defaultValue(uint32_t row) const
+    {
+        return _defaultValues[row];
+    }
+
+    MINICONF_INLINE Value::DataType Config::OptionTable::type(uint32_t row) const
+    {
+        // a choice option without a valid default value is still a choice
+        Value::DataType type = _defaultValues[row].type();
+        if (type == Value::DataType::UNKNOWN && !_choices.empty() && _choices.count(row)) {
+            return Value::DataType::CHOICE;
+        }
+        return type;
+    }
+
+    MINICONF_INLINE const char* Config::OptionTable::flag(uint32_t row) const
+    {
+        return _pool.c_str() + _strings[row].flag;
+    }
+
+    MINICONF_INLINE const char* Config::OptionTable::shortflag(uint32_t row) const
+    {
+        return _pool.c_str() + _strings[row].shortflag;
+    }
+
+    MINICONF_INLINE const char* Config::OptionTable::description(uint32_t row) const
+    {
+        return _pool.c_str() + _strings[row].description;
+    }
+
+    MINICONF_INLINE const std::shared_ptr<const Config::Choices>& Config::OptionTable::choices(uint32_t row) const
+    {
+        static const std::shared_ptr<const Choices> none;
+        auto found = _choices.find(row);
+        return (found != _choices.end()) ? found->second : none;
+    }
+
+    MINICONF_INLINE const std::shared_ptr<const Config::Constraints>& Config::OptionTable::constraints(uint32_t row) const
+    {
+        static const std::shared_ptr<const Constraints> none;
+        auto found = _constraints.find(row);
+        return (found != _constraints.end()) ? found->second : none;
+    }
+
+    MINICONF_INLINE const std::map<uint32_t, std::shared_ptr<const Config::Choices>>& Config::OptionTable::choices() const
+    {
+        return _choices;
+    }
+
+    MINICONF_INLINE const std::map<uint32_t, std::shared_ptr<const Config::Constraints>>& Config::OptionTable::constraints() const
+    {
+        return _constraints;
+    }
+
+    MINICONF_INLINE const std::vector<std::vector<uint32_t>>& Config::OptionTable::groups() const
+    {
+        return _groups;
+    }
+
+    MINICONF_INLINE void Config::OptionTable::group(std::vector<uint32_t>&& rows)
+    {
+        // a group of one option is always complete
+        if (rows.size() > 1) {
+            _groups.push_back(std::move(rows));
+        }
+    }
+
+    MINICONF_INLINE void Config::OptionTable::flag(uint32_t row, const char* flag, size_t length)
+    {
+        if (equals(_strings[row].flag, flag, length)) {
+            return;
+        }
+        // an option of the new flag is replaced
+        uint32_t existing = find(flag, length);
+        if (existing != NONE) {
+            remove(existing);
+        }
+        unindexFlag(row);
+        release(_strings[row].flag);
+        _hashes[row] = FlagTable::hash(flag, length, 0);
+        _strings[row].flag = pool(flag, length);
+        indexFlag(row);
+        compactPool();
+    }
+
+    MINICONF_INLINE void Config::OptionTable::shortflag(uint32_t row, const char* shortflag, size_t length)
+    {
+        if (equals(_strings[row].shortflag, shortflag, length)) {
+            return;
+        }
+        unindexShortflag(row);
+        release(_strings[row].shortflag);
+        _strings[row].shortflag = pool(shortflag, length);
+        indexShortflag(row);
+        compactPool();
+    }
+
+    MINICONF_INLINE void Config::OptionTable::description(uint32_t row, const char* description, size_t length)
+    {
+        if (equals(_strings[row].description, description, length)) {
+            return;
+        }
+        // the text may be shared with the neighbouring rows
+        uint32_t previous = _strings[row].description;
+        if ((row == 0 || _strings[row - 1].description != previous) && 
+            (row + 1 == rows() || _strings[row + 1].description != previous)) {
+            release(previous);
+        }
+        // generated option sets often repeat descriptions, the text of the previous row is shared
+        if (row > 0 && equals(_strings[row - 1].description, description, length)) {
+            _strings[row].description = _strings[row - 1].description;
+        } else {
+            _strings[row].description = pool(description, length);
+        }
+        compactPool();
+    }
+
+    MINICONF_INLINE void Config::OptionTable::defaultValue(uint32_t row, Value&& defaultValue)
+    {
+        // the default value of a choice option is resolved to its code, or unknown if it is not allowed
+        auto found = _choices.empty() ? _choices.end() : _choices.find(row);
+        if (found != _choices.end() && !defaultValue.isEmpty()) {
+            int code = (defaultValue.type() == Value::DataType::STRING || defaultValue.type() == Value::DataType::CHOICE) ? 
+                found->second->find(defaultValue.getCharArray(), defaultValue.length()) : -1;
+            _defaultValues[row] = (code >= 0) ? found->second->value(code) : Value();
+            return;
+        }
+        _defaultValues[row] = std::move(defaultValue);
+    }
+
+    MINICONF_INLINE void Config::OptionTable::required(uint32_t row, bool required)
+    {
+        _bits[row] = required ? (_bits[row] | REQUIRED) : (_bits[row] & ~REQUIRED);
+    }
+
+    MINICONF_INLINE void Config::OptionTable::hidden(uint32_t row, bool hidden)
+    {
+        _bits[row] = hidden ? (_bits[row] | HIDDEN) : (_bits[row] & ~HIDDEN);
+    }
+
+    MINICONF_INLINE void Config::OptionTable::choices(uint32_t row, std::shared_ptr<const Choices> choices)
+    {
+        if (!choices) {
+            // the default value of a former choice option is kept as a string
+            if (_choices.erase(row) && _defaultValues[row].type() == Value::DataType::CHOICE) {
+                _defaultValues[row] = Value(std::string(_defaultValues[row].getCharArray(), _defaultValues[row].length()));
+            }
+            return;
+        }
+        _choices[row] = std::move(choices);
+        // a default value defined before the choices is resolved now
+        defaultValue(row, Value(_defaultValues[row]));
+    }
+
+    MINICONF_INLINE void Config::OptionTable::constraints(uint32_t row, std::shared_ptr<const Constraints> constraints)
+    {
+        if (constraints) {
+            _constraints[row] = std::move(constraints);
+        } else {
+            _constraints.erase(row);
+        }
+    }
+
+    MINICONF_INLINE uint32_t Config::OptionTable::pool(const char* text, size_t length)
+    {
+        if (length == 0) {
+            return 0;
+        }
+        uint32_t offset = static_cast<uint32_t>(_pool.size());
+        _pool.append(text, length);
+        _pool.push_back('\0');
+        return offset;
+    }
+
+    MINICONF_INLINE void Config::OptionTable::release(uint32_t offset)
+    {
+        if (offset == 0) {
+            return;
+        }
+        _garbage += strlen(_pool.c_str() + offset) + 1;
+    }
+
+    MINICONF_INLINE void Config::OptionTable::compactPool()
+    {
+        // compaction is linear in the size of the pool, so it is amortized over the released strings
+        if (_garbage <= 4096 || _garbage * 2 <= _pool.size()) {
+            return;
+        }
+        std::string pooled(1, '\0');
+        pooled.reserve(_pool.size() - _garbage);
+        auto move = [&](uint32_t offset) -> uint32_t {
+            if (offset == 0) {
+                return 0;
+            }
+            const char* text = _pool.c_str() + offset;
+            uint32_t moved = static_cast<uint32_t>(pooled.size());
+            pooled.append(text, strlen(text) + 1);
+            return moved;
+        };
+        // a description shared with the previous row stays shared
+        uint32_t previous = 0;
+        uint32_t previousMoved = 0;
+        for (uint32_t row = 0; row < rows(); ++row) {
+            if (removed(row)) {
+                continue;
+            }
+            Strings& strings = _strings[row];
+            strings.flag = move(strings.flag);
+            strings.shortflag = move(strings.shortflag);
+            if (strings.description != 0 && strings.description == previous) {
+                strings.description = previousMoved;
+            } else {
+                previous = strings.description;
+                strings.description = previousMoved = move(strings.description);
+            }
+        }
+        _pool.swap(pooled);
+        _garbage = 0;
+    }
+
+    MINICONF_INLINE bool Config::OptionTable::equals(uint32_t offset, const char* text, size_t length) const
+    {
+        // strncmp stops at the end of the pooled string
+        const char* pooled = _pool.c_str() + offset;
+        return strncmp(pooled, text, length) == 0 && pooled[length] == '\0';
+    }
+
+    MINICONF_INLINE void Config::OptionTable::index(uint32_t row)
+    {
+        // load factor of 0.5 at most
+        if (_size * 2 > _index.size()) {
+            rebuildIndex(_size);
+            return;
+        }
+        indexFlag(row);
+        indexShortflag(row);
+    }
+
+    MINICONF_INLINE void Config::OptionTable::rebuildIndex(size_t count)
+    {
+        size_t capacity = 16;
+        while (capacity < count * 2) {
+            capacity *= 2;
+        }
+        _index.assign(capacity, static_cast<uint32_t>(NONE));
+        _shortflagIndex.assign(capacity, static_cast<uint32_t>(NONE));
+        for (uint32_t row = 0; row < rows(); ++row) {
+            if (removed(row)) {
+                continue;
+            }
+            _bits[row] &= ~DUPLICATE_SHORTFLAG;
+            indexFlag(row);
+            indexShortflag(row);
+        }
+    }
+
+    MINICONF_INLINE void Config::OptionTable::indexFlag(uint32_t row)
+    {
+        size_t mask = _index.size() - 1;
+        size_t slot = _hashes[row] & mask;
+        while (_index[slot] != NONE) {
+            slot = (slot + 1) & mask;
+        }
+        _index[slot] = row;
+    }
+
+    MINICONF_INLINE void Config::OptionTable::indexShortflag(uint32_t row)
+    {
+        const char* text = shortflag(row);
+        size_t length = strlen(text);
+        if (length == 0) {
+            return;
+        }
+        size_t mask = _shortflagIndex.size() - 1;
+        size_t slot = FlagTable::hash(text, length, 1) & mask;
+        for (; _shortflagIndex[slot] != NONE; slot = (slot + 1) & mask) {
+            uint32_t first = _shortflagIndex[slot];
+            if (equals(_strings[first].shortflag, text, length)) {
+                // the first option keeps the short flag, both are marked
+                _bits[first] |= DUPLICATE_SHORTFLAG;
+                _bits[row] |= DUPLICATE_SHORTFLAG;
+                return;
+            }
+        }
+        _shortflagIndex[slot] = row;
+    }
+
+    MINICONF_INLINE void Config::OptionTable::unindexFlag(uint32_t row)
+    {
+        size_t mask = _index.size() - 1;
+        for (size_t slot = _hashes[row] & mask; _index[slot] != NONE; slot = (slot + 1) & mask) {
+            if (_index[slot] == row) {
+                eraseSlot(_index, slot, false);
+                return;
+            }
+        }
+    }
+
+    MINICONF_INLINE void Config::OptionTable::unindexShortflag(uint32_t row)
+    {
+        const char* text = shortflag(row);
+        size_t length = strlen(text);
+        if (length == 0) {
+            return;
+        }
+        size_t mask = _shortflagIndex.size() - 1;
+        for (size_t slot = FlagTable::hash(text, length, 1) & mask; _shortflagIndex[slot] != NONE; slot = (slot + 1) & mask) {
+            if (_shortflagIndex[slot] == row) {
+                eraseSlot(_shortflagIndex, slot, true);
+                break;
+            }
+        }
+        if (!duplicateShortflag(row)) {
+            return;
+        }
+        // the other options of a duplicated short flag are rare, they are found by a scan
+        _bits[row] &= ~DUPLICATE_SHORTFLAG;
+        std::vector<uint32_t> others;
+        for (uint32_t other = 0; other < rows(); ++other) {
+            if (other != row && !removed(other) && equals(_strings[other].shortflag, text, length)) {
+                _bits[other] &= ~DUPLICATE_SHORTFLAG;
+                others.push_back(other);
+            }
+        }
+        for (auto && other : others) {
+            if (findShortflag(text, length) != other) {
+                indexShortflag(other);
+            }
+        }
+    }
+
+    MINICONF_INLINE void Config::OptionTable::eraseSlot(std::vector<uint32_t>& index, size_t slot, bool shortflags)
+    {
+        size_t mask = index.size() - 1;
+        for (size_t next = (slot + 1) & mask; index[next] != NONE; next = (next + 1) & mask) {
+            uint32_t row = index[next];
+            const char* text = shortflags ? shortflag(row) : nullptr;
+            size_t home = (shortflags ? FlagTable::hash(text, strlen(text), 1) : _hashes[row]) & mask;
+            // a row is moved to the empty slot unless its home slot lies between the empty slot and its slot
+            if (((next - home) & mask) >= ((next - slot) & mask)) {
+                index[slot] = row;
+                slot = next;
+            }
+        }
+        index[slot] = NONE;
+    }
+
+    // FeatureFlags
+    MINICONF_INLINE Config::FeatureFlags::FeatureFlags() : _words(1, 0)
+    {}
+
+    MINICONF_INLINE uint32_t Config::FeatureFlags::id(const std::string& flag) const
+    {
+        if (!_options) {
+            return NONE;
+        }
+        uint32_t row = _options->find(flag.data(), flag.size());
+        if (row == OptionTable::NONE) {
+            return NONE;
+        }
+        auto found = std::lower_bound(_rows->begin(), _rows->end(), row);
+        if (found == _rows->end() || *found != row) {
+            return NONE;
+        }
+        return static_cast<uint32_t>(found - _rows->begin());
+    }
+
+    MINICONF_INLINE const char* Config::FeatureFlags::flag(uint32_t id) const
+    {
+        return _options->flag((*_rows)[id]);
+    }
+
+    MINICONF_INLINE size_t Config::FeatureFlags::size() const
+    {
+        return _rows ? _rows->size() : 0;
+    }
+
+    // FeatureStore
+    MINICONF_INLINE Config::FeatureStore::FeatureStore()
+    {}
+
+    MINICONF_INLINE Config::FeatureStore::FeatureStore(std::shared_ptr<const FeatureFlags> flags) : _flags(std::move(flags))
+    {}
+
+    MINICONF_INLINE std::shared_ptr<const Config::FeatureFlags> Config::FeatureStore::load() const
+    {
+        return std::atomic_load(&_flags);
+    }
+
+    MINICONF_INLINE void Config::FeatureStore::store(std::shared_ptr<const FeatureFlags> flags)
+    {
+        std::atomic_store(&_flags, std::move(flags));
+    }
+
+    // ValueColumns
+    MINICONF_INLINE Config::ValueColumns::ValueColumns() : _pool(1, '\0')
+    {}
+
+    MINICONF_INLINE uint32_t Config::ValueColumns::id(const std::string& flag) const
+    {
+        if (!_options) {
+            return NONE;
+        }
+        uint32_t row = _options->find(flag.data(), flag.size());
+        if (row == OptionTable::NONE) {
+            return NONE;
+        }
+        auto found = std::lower_bound(_layout->rows.begin(), _layout->rows.end(), row);
+        if (found == _layout->rows.end() || *found != row) {
+            return NONE;
+        }
+        return static_cast<uint32_t>(found - _layout->rows.begin());
+    }
+
+    MINICONF_INLINE const char* Config::ValueColumns::flag(uint32_t id) const
+    {
+        return _options->flag(_layout->rows[id]);
+    }
+
+    MINICONF_INLINE size_t Config::ValueColumns::size() const
+    {
+        return _layout ? _layout->rows.size() : 0;
+    }
+
+    MINICONF_INLINE Value::DataType Config::ValueColumns::type(uint32_t id) const
+    {
+        return _layout->types[id];
+    }
+
+    MINICONF_INLINE bool Config::ValueColumns::defined(uint32_t id) const
+    {
+        return _defined[id] != 0;
+    }
+
+    MINICONF_INLINE Value Config::ValueColumns::value(uint32_t id) const
+    {
+        if (!defined(id)) {
+            return Value();
+        }
+        uint32_t slot = _layout->slots[id];
+        switch (_layout->types[id]) {
+            case Value::DataType::INT:
+                return Value(static_cast<int>(_ints[slot]));
+            case Value::DataType::INT64:
+                return Value(_ints[slot]);
+            case Value::DataType::UINT64:
+                return Value(static_cast<uint64_t>(_ints[slot]));
+            case Value::DataType::DURATION:
+                return Value::duration(_ints[slot]);
+            case Value::DataType::BYTES:
+                return Value::bytes(static_cast<uint64_t>(_ints[slot]));
+            case Value::DataType::CHOICE:
+                return _options->choices(_layout->rows[id])->value(static_cast<int>(_ints[slot]));
+            case Value::DataType::NUMBER:
+                return Value(_numbers[slot]);
+            case Value::DataType::BOOL:
+                return Value(_booleans[slot] != 0);
+            case Value::DataType::STRING:
+                return Value(_pool.c_str() + _strings[slot]);
+            default:
+                return Value();
+        }
+    }
+
+    MINICONF_INLINE Config::ValueColumns::Column<int64_t> Config::ValueColumns::ints() const
+    {
+        Column<int64_t> c = {_ints.data(), _layout ? _layout->ids[0].data() : nullptr, _ints.size()};
+        return c;
+    }
+
+    MINICONF_INLINE Config::ValueColumns::Column<double> Config::ValueColumns::numbers() const
+    {
+        Column<double> c = {_numbers.data(), _layout ? _layout->ids[1].data() : nullptr, _numbers.size()};
+        return c;
+    }
+
+    MINICONF_INLINE Config::ValueColumns::Column<uint8_t> Config::ValueColumns::booleans() const
+    {
+        Column<uint8_t> c = {_booleans.data(), _layout ? _layout->ids[2].data() : nullptr, _booleans.size()};
+        return c;
+    }
+
+    MINICONF_INLINE Config::ValueColumns::Column<uint32_t> Config::ValueColumns::strings() const
+    {
+        Column<uint32_t> c = {_strings.data(), _layout ? _layout->ids[3].data() : nullptr, _strings.size()};
+        return c;
+    }
+
+    MINICONF_INLINE const std::string& Config::ValueColumns::stringPool() const
+    {
+        return _pool;
+    }
+
+    MINICONF_INLINE uint64_t Config::ValueColumns::hash() const
+    {
+        // FNV-1a over the bytes of the columns, undefined values are zero in their columns
+        uint64_t h = 14695981039346656037ULL;
+        auto add = [&h](const void* data, size_t size) {
+            const unsigned char* bytes = static_cast<const unsigned char*>(data);
+            for (size_t i = 0; i < size; ++i) {
+                h = (h ^ bytes[i]) * 1099511628211ULL;
+            }
+        };
+        add(_defined.data(), _defined.size());
+        add(_ints.data(), _ints.size() * sizeof(int64_t));
+        add(_numbers.data(), _numbers.size() * sizeof(double));
+        add(_booleans.data(), _booleans.size());
+        // the strings are hashed in slot order, their offsets depend on the order of loading
+        for (uint32_t offset : _strings) {
+            add(_pool.c_str() + offset, strlen(_pool.c_str() + offset) + 1);
+        }
+        return h;
+    }
+
+    MINICONF_INLINE bool Config::ValueColumns::diff(const ValueColumns& other, std::vector<uint32_t>& ids) const
+    {
+        if (!sameLayout(other)) {
+            return false;
+        }
+        const Layout& layout = *_layout;
+        size_t first = ids.size();
+        for (size_t id = 0; id < _defined.size(); ++id) {
+            if (_defined[id] != other._defined[id]) {
+                ids.push_back(static_cast<uint32_t>(id));
+            }
+        }
+        for (size_t i = 0; i < _ints.size(); ++i) {
+            if (_ints[i] != other._ints[i]) {
+                ids.push_back(layout.ids[0][i]);
+            }
+        }
+        for (size_t i = 0; i < _numbers.size(); ++i) {
+            if (memcmp(&(_numbers[i]), &(other._numbers[i]), sizeof(double)) != 0) {
+                ids.push_back(layout.ids[1][i]);
+            }
+        }
+        for (size_t i = 0; i < _booleans.size(); ++i) {
+            if (_booleans[i] != other._booleans[i]) {
+                ids.push_back(layout.ids[2][i]);
+            }
+        }
+        for (size_t i = 0; i < _strings.size(); ++i) {
+            if (strcmp(_pool.c_str() + _strings[i], other._pool.c_str() + other._strings[i]) != 0) {
+                ids.push_back(layout.ids[3][i]);
+            }
+        }
+        // an ID may be collected twice if its value is also undefined in one snapshot
+        std::sort(ids.begin() + first, ids.end());
+        ids.erase(std::unique(ids.begin() + first, ids.end()), ids.end());
+        return true;
+    }
+
+    MINICONF_INLINE int Config::ValueColumns::column(Value::DataType type)
+    {
+        switch (type) {
+            case Value::DataType::INT:
+            case Value::DataType::INT64:
+            case Value::DataType::UINT64:
+            case Value::DataType::DURATION:
+            case Value::DataType::BYTES:
+            case Value::DataType::CHOICE:
+                return 0;
+            case Value::DataType::NUMBER:
+                return 1;
+            case Value::DataType::BOOL:
+                return 2;
+            case Value::DataType::STRING:
+                return 3;
+            default:
+                return -1;
+        }
+    }
+
+    MINICONF_INLINE bool Config::ValueColumns::sameLayout(const ValueColumns& other) const
+    {
+        if (!_layout || !other._layout) {
+            return _layout == other._layout;
+        }
+        if (_layout == other._layout || _options == other._options) {
+            return true;
+        }
+        // snapshots of copies of a Config may have their own layouts of the same options
+        if (_layout->types != other._layout->types) {
+            return false;
+        }
+        for (uint32_t id = 0; id < _layout->rows.size(); ++id) {
+            if (strcmp(flag(id), other.flag(id)) != 0) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // Reference
+    MINICONF_INLINE Config::Reference::Reference(Config& config, const std::string& flag, const Value* value) : 
+        Value(value ? *value : Value()), _config(&config), _flag(flag)
+    {}
+
+    MINICONF_INLINE Config::Reference& Config::Reference::operator=(const Value& other)
+    {
+        Value& target = _config->modifiable(_flag);
+        target = other;
+        Value::operator=(target);
+        return *this;
+    }
+
+    MINICONF_INLINE Config::Reference& Config::Reference::operator=(Value&& other)
+    {
+        Value& target = _config->modifiable(_flag);
+        target = std::move(other);
+        Value::operator=(target);
+        return *this;
+    }
+
+    MINICONF_INLINE Config::Reference& Config::Reference::operator=(const Reference& other)
+    {
+        return *this = static_cast<const Value&>(other);
+    }
+
+    MINICONF_INLINE Config::Reference& Config::Reference::operator=(const int& other)
+    {
+        return *this = Value(other);
+    }
+
+    MINICONF_INLINE Config::Reference& Config::Reference::operator=(const double& other)
+    {
+        return *this = Value(other);
+    }
+
+    MINICONF_INLINE Config::Reference& Config::Reference::operator=(const bool& other)
+    {
+        return *this = Value(other);
+    }
+
+    MINICONF_INLINE Config::Reference& Config::Reference::operator=(const int64_t& other)
+    {
+        return *this = Value(other);
+    }
+
+    MINICONF_INLINE Config::Reference& Config::Reference::operator=(const uint64_t& other)
+    {
+        return *this = Value(other);
+    }
+
+    MINICONF_INLINE Config::Reference& Config::Reference::operator=(const char* other)
+    {
+        return *this = Value(other);
+    }
+
+    MINICONF_INLINE Config::Reference& Config::Reference::operator=(const std::string& other)
+    {
+        return *this = Value(other);
+    }
+
+    // Overlay
+    MINICONF_INLINE Config::Overlay::Overlay(const Config& base) : _base(&base), _size(0)
+    {}
+
+    MINICONF_INLINE Config::Overlay& Config::Overlay::set(const std::string& flag, const Value& value)
+    {
+        bool inserted = false;
+        *slot(flag, inserted) = value;
+        return *this;
+    }
+
+    MINICONF_INLINE Config::Overlay& Config::Overlay::set(const std::string& flag, Value&& value)
+    {
+        bool inserted = false;
+        *slot(flag, inserted) = std::move(value);
+        return *this;
+    }
+
+    MINICONF_INLINE Value& Config::Overlay::operator[](const std::string& flag)
+    {
+        bool inserted = false;
+        Value* v = slot(flag, inserted);
+        if (inserted) {
+            // copy on write
+            *v = _base->value(flag);
+        }
+        return *v;
+    }
+
+    MINICONF_INLINE const Value& Config::Overlay::value(const std::string& flag) const
+    {
+        const Value* found = find(flag);
+        return found ? *found : _base->value(flag);
+    }
+
+    MINICONF_INLINE bool Config::Overlay::overrides(const std::string& flag) const
+    {
+        return find(flag) != nullptr;
+    }
+
+    MINICONF_INLINE void Config::Overlay::clear()
+    {
+        for (size_t i = 0; i < _size; ++i) {
+            _entries[i].value = Value();
+        }
+        _size = 0;
+        _spill.clear();
+    }
+
+    MINICONF_INLINE const Config& Config::Overlay::base() const
+    {
+        return *_base;
+    }
+
+    MINICONF_INLINE const Value* Config::Overlay::find(const std::string& flag) const
+    {
+        for (size_t i = 0; i < _size; ++i) {
+            if (flag == _entries[i].flag) {
+                return &(_entries[i].value);
+            }
+        }
+        if (!_spill.empty()) {
+            auto found = _spill.find(flag);
+            if (found != _spill.end()) {
+                return &(found->second);
+            }
+        }
+        return nullptr;
+    }
+
+    MINICONF_INLINE Value* Config::Overlay::slot(const std::string& flag, bool& inserted)
+    {
+        inserted = false;
+        for (size_t i = 0; i < _size; ++i) {
+            if (flag == _entries[i].flag) {
+                return &(_entries[i].value);
+            }
+        }
+        auto spilled = _spill.find(flag);
+        if (spilled != _spill.end()) {
+            return &(spilled->second);
+        }
+        inserted = true;
+        // the option flag of the base is used as the inline key, so no string is copied
+        uint32_t row = _base->_options->find(flag.data(), flag.size());
+        if (_size < INLINE_SIZE && row != OptionTable::NONE) {
+            _entries[_size].flag = _base->_options->flag(row);
+            return &(_entries[_size++].value);
+        }
+        return &(_spill[flag]);
+    }
+
+    MINICONF_INLINE Config::LazyValues::LazyValues(std::string&& content, ExportFormat format) :
+        _content(std::move(content)), _format(format)
+    {}
+
+    MINICONF_INLINE const std::string& Config::LazyValues::content() const
+    {
+        return _content;
+    }
+
+    MINICONF_INLINE void Config::LazyValues::add(std::string&& flag, size_t offset, size_t length, Value::DataType type)
+    {
+        _slices.push_back(Slice{std::move(flag), offset, length, type});
+    }
+
+    MINICONF_INLINE void Config::LazyValues::seal()
+    {
+        // open addressing index with a load factor of 0.5 at most
+        size_t capacity = 16;
+        while (capacity < _slices.size() * 2) {
+            capacity *= 2;
+        }
+        _index.assign(capacity, static_cast<uint32_t>(EMPTY));
+        size_t duplicates = 0;
+        for (size_t i = 0; i < _slices.size(); ++i) {
+            uint32_t& slot = _index[findSlot(_slices[i].flag)];
+            if (slot != EMPTY) {
+                // the earlier slice of the same flag is replaced
+                _slices[slot].length = std::string::npos;
+                ++duplicates;
+            }
+            slot = static_cast<uint32_t>(i);
+        }
+        if (duplicates > 0) {
+            _slices.erase(std::remove_if(_slices.begin(), _slices.end(), [](const Slice& s) { 
+                return s.length == std::string::npos; 
+            }), _slices.end());
+            _index.assign(capacity, static_cast<uint32_t>(EMPTY));
+            for (size_t i = 0; i < _slices.size(); ++i) {
+                _index[findSlot(_slices[i].flag)] = static_cast<uint32_t>(i);
+            }
+        }
+        _cache.reset(new Cache[_slices.size()]);
+    }
+
+    MINICONF_INLINE size_t Config::LazyValues::size() const
+    {
+        return _slices.size();
+    }
+
+    MINICONF_INLINE const std::string& Config::LazyValues::flag(size_t index) const
+    {
+        return _slices[index].flag;
+    }
+
+    MINICONF_INLINE const Value& Config::LazyValues::value(size_t index) const
+    {
+        Cache& cache = _cache[index];
+        std::call_once(cache.once, [&]() {
+            cache.value = convert(_slices[index]);
+        });
+        return cache.value;
+    }
+
+    MINICONF_INLINE size_t Config::LazyValues::find(const std::string& flag) const
+    {
+        if (_index.empty()) {
+            return _slices.size();
+        }
+        uint32_t index = _index[findSlot(flag)];
+        return (index == EMPTY) ? _slices.size() : index;
+    }
+
+    MINICONF_INLINE size_t Config::LazyValues::findSlot(const std::string& flag) const
+    {
+        const size_t mask = _index.size() - 1;
+        for (size_t i = FlagTable::hash(flag.data(), flag.size(), 0) & mask; ; i = (i + 1) & mask) {
+            if (_index[i] == EMPTY || _slices[_index[i]].flag == flag) {
+                return i;
+            }
+        }
+    }
+
+    MINICONF_INLINE Value Config::LazyValues::convert(const Slice& slice) const
+    {
+        const char* first = _content.data() + slice.offset;
+        const char* last = first + slice.length;
+#ifdef MINICONF_JSON_SUPPORT
+        if (_format == ExportFormat::JSON) {
+            picojson::value v;
+            std::string err;
+            picojson::parse(v, first, last, &err);
+            return err.empty() ? fromJSONValue(&v, slice.type) : Value::unknown();
+        }
+#endif
+        // stray values are parsed as strings
+        return Value::parse(std::string(first, last).c_str(), 
+            (slice.type == Value::DataType::UNKNOWN) ? Value::DataType::STRING : slice.type);
+    }
+
+    MINICONF_INLINE Config::Config() :
+        _options(std::make_shared<OptionTable>()),
+        _verbose(false),
+        _logLevel(Config::LogLevel::WARNING),
+        _exeName(""),
+        _description(""),
+        _autoHelp(true),
+        _loadConfig(true),
+        _lazyLoading(false),
+        _flagTable(nullptr)
+    {
+        enableHelp(true); // set auto help to true
+        enableConfig(true); // set auto config to true
+    }
+
+    MINICONF_INLINE Config::Config(std::shared_ptr<const Schema> schema) :
+        _options(schema->_options),
+        _verbose(schema->_verbose),
+        _logLevel(schema->_logLevel),
+        _exeName(""),
+        _description(""),
+        _autoHelp(schema->_autoHelp),
+        _loadConfig(schema->_loadConfig),
+        _lazyLoading(schema->_lazyLoading),
+        _flagTable(schema->_flagTable),
+        _validator(schema->_validator),
+        _schema(std::move(schema))
+    {
+        // the "help" and "config" options are defined by the schema
+    }
+
+    MINICONF_INLINE Config::~Config()
+    {
+        _handles.options.clear();
+        _options.reset();
+        for (auto && l : _layers) {
+            l.clear();
+        }
+        for (auto && l : _lazyLayers) {
+            l.clear();
+        }
+        _log.clear();
+    }
+
+    MINICONF_INLINE Config::Option& Config::option(const std::string& flag)
+    {
+        // one search for both existing and new options
+        return handle(mutableOptions().insert(flag.data(), flag.size()));
+    }
+
+    MINICONF_INLINE Config::Option& Config::option(std::string&& flag)
+    {
+        return handle(mutableOptions().insert(flag.data(), flag.size()));
+    }
+
+    MINICONF_INLINE Config::Option& Config::option(const char* flag)
+    {
+        return handle(mutableOptions().insert(flag, strlen(flag)));
+    }
+
+#ifdef MINICONF_HAS_STRING_VIEW
+    MINICONF_INLINE Config::Option& Config::option(std::string_view flag)
+    {
+        return handle(mutableOptions().insert(flag.data(), flag.size()));
+    }
+#endif
+
+    MINICONF_INLINE void Config::reserve(size_t count)
+    {
+        mutableOptions().reserve(count);
+    }
+
+    MINICONF_INLINE Config::Option& Config::handle(uint32_t row)
+    {
+        // handles are only created for the options defined one by one
+        Option& option = _handles.options[row];
+        option._owner = this;
+        option._row = row;
+        return option;
+    }
+
+    MINICONF_INLINE void Config::options(std::vector<Option> options)
+    {
+        // the options are written to the rows directly, no Option object is kept
+        OptionTable& table = mutableOptions();
+        table.reserve(table.rows() + options.size());
+        for (auto && o : options) {
+            // definitions of detached options are owned by the list, their default values are moved
+            Option::Definition copy;
+            Option::Definition& d = o._owner ? (copy = o.definition()) : o.mutableDetached();
+            if (d.flag.empty()) {
+                continue;
+            }
+            uint32_t row = table.insert(d.flag.data(), d.flag.size());
+            table.shortflag(row, d.shortflag.data(), d.shortflag.size());
+            table.description(row, d.description.data(), d.description.size());
+            table.choices(row, std::move(d.choices));
+            table.constraints(row, std::move(d.constraints));
+            table.defaultValue(row, std::move(d.defaultValue));
+            table.required(row, d.required);
+            table.hidden(row, d.hidden);
+        }
+    }
+
+    MINICONF_INLINE std::shared_ptr<const Config::Schema> Config::schema()
+    {
+        std::shared_ptr<Schema> schema(new Schema());
+        schema->_format = checkFormat();
+        // the handles returned by option() keep modifying the table of this object, not the copy
+        schema->_options = std::make_shared<OptionTable>(*_options);
+        schema->_validator = std::make_shared<Validator>(schema->_options);
+        schema->_description = _description;
+        schema->_verbose = _verbose;
+        schema->_logLevel = _logLevel;
+        schema->_autoHelp = _autoHelp;
+        schema->_loadConfig = _loadConfig;
+        schema->_lazyLoading = _lazyLoading;
+        schema->_flagTable = _flagTable;
+        return schema;
+    }
+
+    MINICONF_INLINE void Config::requireTogether(const std::vector<std::string>& flags)
+    {
+        // the table is copied before the rows are found, a copy drops the removed rows
+        OptionTable& options = mutableOptions();
+        std::vector<uint32_t> rows;
+        for (auto && flag : flags) {
+            uint32_t row = options.find(flag.data(), flag.size());
+            if (row == OptionTable::NONE) {
+                log(LogLevel::ERROR, flag, "option is undefined");
+            } else {
+                rows.push_back(row);
+            }
+        }
+        options.group(std::move(rows));
+    }
+
+    MINICONF_INLINE bool Config::remove(const std::string& flag)
+    {
+        if (findOption(flag)){
+            OptionTable& options = mutableOptions();
+            options.remove(options.find(flag.data(), flag.size())); 
+            return true; 
+        }
+        return false; 
+    }
+
+    MINICONF_INLINE Config::OptionTable& Config::mutableOptions()
+    {
+        if (_options.use_count() > 1) {
+            // the rows of the options returned by option() must stay valid, so the copy is only compacted without them
+            _options = std::make_shared<OptionTable>(*_options, _handles.options.empty());
+        }
+        // options resolved from the flag table may be moved or removed
+        _flagTableOptions.clear();
+        return *_options;
+    }
+
+    MINICONF_INLINE const std::string& Config::programDescription() const
+    {
+        return (_description.empty() && _schema) ? _schema->_description : _description;
+    }
+
+    MINICONF_INLINE std::map<std::string, Value>& Config::layer(Source source)
+    {
+        return _layers[static_cast<int>(source) - static_cast<int>(Source::CONFIG)];
+    }
+
+    MINICONF_INLINE std::vector<std::shared_ptr<const Config::LazyValues>>& Config::lazyLayer(Source source)
+    {
+        return _lazyLayers[static_cast<int>(source) - static_cast<int>(Source::CONFIG)];
+    }
+
+    MINICONF_INLINE const Value* Config::lookup(const std::string& flag, Source* source) const
+    {
+        // search from the layer of the highest precedence
+        for (int i = LAYERS - 1; i >= 0; --i) {
+            const Value* value = nullptr;
+            auto found = _layers[i].find(flag);
+            if (found != _layers[i].end()) {
+                value = &(found->second);
+            }
+            // lazily loaded values are converted on first access, the latest file comes first
+            for (auto lazy = _lazyLayers[i].rbegin(); !value && lazy != _lazyLayers[i].rend(); ++lazy) {
+                size_t index = (*lazy)->find(flag);
+                if (index < (*lazy)->size()) {
+                    value = &((*lazy)->value(index));
+                }
+            }
+            if (value) {
+                if (source) {
+                    *source = static_cast<Source>(i + static_cast<int>(Source::CONFIG));
+                }
+                return value;
+            }
+        }
+        // default values of hidden options are not exposed
+        uint32_t row = _options->find(flag.data(), flag.size());
+        if (row != OptionTable::NONE && !_options->hidden(row)) {
+            if (source) {
+                *source = Source::DEFAULT;
+            }
+            return &(_options->defaultValue(row));
+        }
+        if (source) {
+            *source = Source::NONE;
+        }
+        return nullptr;
+    }
+
+    MINICONF_INLINE Config::Source Config::locate(const std::string& flag) const
+    {
+        for (int i = LAYERS - 1; i >= 0; --i) {
+            bool found = _layers[i].find(flag) != _layers[i].end();
+            for (auto && lazy : _lazyLayers[i]) {
+                found = found || lazy->find(flag) < lazy->size();
+            }
+            if (found) {
+                return static_cast<Source>(i + static_cast<int>(Source::CONFIG));
+            }
+        }
+        uint32_t row = _options->find(flag.data(), flag.size());
+        if (row != OptionTable::NONE && !_options->hidden(row)) {
+            return Source::DEFAULT;
+        }
+        return Source::NONE;
+    }
+
+    MINICONF_INLINE Config::LogLevel Config::resolveChoices(Source source)
+    {
+        LogLevel result = LogLevel::INFO;
+        if (_options->choices().empty()) {
+            return result;
+        }
+        auto& values = layer(source);
+        std::string flag;
+        for (auto && c : _options->choices()) {
+            flag = _options->flag(c.first);
+            auto found = values.find(flag);
+            bool lazyValue = false;
+            if (found == values.end()) {
+                // a lazily loaded choice is resolved into the layer, which shadows the lazy values
+                const Value* lazy = nullptr;
+                for (auto it = lazyLayer(source).rbegin(); !lazy && it != lazyLayer(source).rend(); ++it) {
+                    size_t index = (*it)->find(flag);
+                    if (index < (*it)->size()) {
+                        lazy = &((*it)->value(index));
+                    }
+                }
+                if (!lazy || lazy->type() != Value::DataType::STRING) {
+                    continue;
+                }
+                found = values.emplace(flag, *lazy).first;
+                lazyValue = true;
+            }
+            if (found->second.type() != Value::DataType::STRING) {
+                continue;
+            }
+            int code = c.second->find(found->second.getCharArray(), found->second.length());
+            if (code < 0) {
+                if (logEnabled(LogLevel::ERROR)) {
+                    log(LogLevel::ERROR, flag, "invalid choice \"", found->second.getString(), "\", allowed values: ", c.second->list());
+                }
+                result = LogLevel::ERROR;
+                if (lazyValue) {
+                    // the lazy value cannot be removed, it is shadowed by the default value
+                    found->second = _options->defaultValue(c.first);
+                } else {
+                    values.erase(found);
+                }
+            } else {
+                found->second = c.second->value(code);
+            }
+        }
+        return result;
+    }
+
+    MINICONF_INLINE void Config::values(std::map<std::string, const Value*>& values) const
+    {
+        for (uint32_t row = 0; row < _options->rows(); ++row) {
+            if (!_options->removed(row) && !_options->hidden(row)) {
+                values[_options->flag(row)] = &(_options->defaultValue(row));
+            }
+        }
+        for (int i = 0; i < LAYERS; ++i) {
+            // lazily loaded values are shadowed by the other values of the same layer
+            for (auto && lazy : _lazyLayers[i]) {
+                for (size_t index = 0; index < lazy->size(); ++index) {
+                    values[lazy->flag(index)] = &(lazy->value(index));
+                }
+            }
+            for (auto && v : _layers[i]) {
+                values[v.first] = &(v.second);
+            }
+        }
+    }
+
+    MINICONF_INLINE std::shared_ptr<const Config::FeatureFlags> Config::featureFlags()
+    {
+        std::shared_ptr<FeatureFlags> flags(new FeatureFlags());
+        // the option table is shared by the snapshot, so it is copied before it is modified
+        if (_featureFlags && _featureFlags->_options == _options) {
+            flags->_options = _featureFlags->_options;
+            flags->_rows = _featureFlags->_rows;
+        } else {
+            std::shared_ptr<std::vector<uint32_t>> rows = std::make_shared<std::vector<uint32_t>>();
+            for (uint32_t row = 0; row < _options->rows(); ++row) {
+                if (!_options->removed(row) && !_options->hidden(row) && _options->type(row) == Value::DataType::BOOL) {
+                    rows->push_back(row);
+                }
+            }
+            flags->_options = _options;
+            flags->_rows = rows;
+        }
+        const std::vector<uint32_t>& rows = *(flags->_rows);
+        flags->_words.assign((rows.size() + 63) / 64 + 1, 0);
+        std::string flag;
+        for (size_t id = 0; id < rows.size(); ++id) {
+            flag = _options->flag(rows[id]);
+            const Value* value = lookup(flag);
+            if (value && value->type() == Value::DataType::BOOL && value->getBoolean()) {
+                flags->_words[id >> 6] |= uint64_t(1) << (id & 63);
+            }
+        }
+        _featureFlags = flags;
+        return flags;
+    }
+
+    MINICONF_INLINE std::shared_ptr<const Config::ValueColumns> Config::valueColumns()
+    {
+        std::shared_ptr<ValueColumns> columns(new ValueColumns());
+        // the option table is shared by the snapshot, so it is copied before it is modified
+        if (_valueColumns && _valueColumns->_options == _options) {
+            columns->_layout = _valueColumns->_layout;
+        } else {
+            std::shared_ptr<ValueColumns::Layout> layout = std::make_shared<ValueColumns::Layout>();
+            for (uint32_t row = 0; row < _options->rows(); ++row) {
+                Value::DataType type = _options->type(row);
+                int column = ValueColumns::column(type);
+                if (_options->removed(row) || _options->hidden(row) || column < 0) {
+                    continue;
+                }
+                uint32_t id = static_cast<uint32_t>(layout->rows.size());
+                layout->rows.push_back(row);
+                layout->types.push_back(type);
+                layout->slots.push_back(static_cast<uint32_t>(layout->ids[column].size()));
+                layout->ids[column].push_back(id);
+            }
+            columns->_layout = layout;
+        }
+        columns->_options = _options;
+        const ValueColumns::Layout& layout = *(columns->_layout);
+        columns->_ints.assign(layout.ids[0].size(), 0);
+        columns->_numbers.assign(layout.ids[1].size(), 0.0);
+        columns->_booleans.assign(layout.ids[2].size(), 0);
+        columns->_strings.assign(layout.ids[3].size(), 0);
+        columns->_defined.assign(layout.rows.size(), 0);
+        std::string flag;
+        for (size_t id = 0; id < layout.rows.size(); ++id) {
+            flag = _options->flag(layout.rows[id]);
+            const Value* value = lookup(flag);
+            Value::DataType type = layout.types[id];
+            if (!value || value->type() != type) {
+                continue;
+            }
+            columns->_defined[id] = 1;
+            uint32_t slot = layout.slots[id];
+            switch (type) {
+                case Value::DataType::INT:
+                    columns->_ints[slot] = value->getInt();
+                    break;
+                case Value::DataType::INT64:
+                    columns->_ints[slot] = value->getInt64();
+                    break;
+                case Value::DataType::UINT64:
+                    columns->_ints[slot] = static_cast<int64_t>(value->getUInt64());
+                    break;
+                case Value::DataType::DURATION:
+                    columns->_ints[slot] = value->getDuration();
+                    break;
+                case Value::DataType::BYTES:
+                    columns->_ints[slot] = static_cast<int64_t>(value->getBytes());
+                    break;
+                case Value::DataType::CHOICE:
+                    columns->_ints[slot] = value->getChoice();
+                    break;
+                case Value::DataType::NUMBER:
+                    columns->_numbers[slot] = value->getNumber();
+                    break;
+                case Value::DataType::BOOL:
+                    columns->_booleans[slot] = value->getBoolean() ? 1 : 0;
+                    break;
+                default:
+                    columns->_strings[slot] = static_cast<uint32_t>(columns->_pool.size());
+                    columns->_pool.append(value->getCharArray(), value->length());
+                    columns->_pool.push_back('\0');
+                    break;
+            }
+        }
+        _valueColumns = columns;
+        return columns;
+    }
+
+    MINICONF_INLINE void Config::log(const LogLevel logType)
+    {
+        _logLevel = logType;
+    }
+
+    MINICONF_INLINE void Config::log(FILE* fd)
+    {
+        fprintf(fd, "\n[[[  %s  ]]]\n\n", "PARSE LOG");
+        for (auto && logline : _log) {
+            fprintf(fd, "%s\n", logline.c_str());
+        }
+    }
+
+    // the check is inlined in the library mode too, so disabled messages are not built
+    inline bool Config::logEnabled(Config::LogLevel logType) const
+    {
+        return static_cast<int>(logType) >= MINICONF_MIN_LOG_LEVEL && logType >= _logLevel;
+    }
+
+    template <typename Token, typename... Parts>
+    void Config::log(Config::LogLevel logType, const Token& token, const Parts&... msg)
+    {
+        // do don't anything if log level is low
+        if (!logEnabled(logType)) {
+            return;
+        }
+        std::string tokenString;
+        std::string msgString;
+        appendLog(tokenString, token);
+        appendLog(msgString, msg...);
+        addLog(logType, tokenString, msgString);
+    }
+
+    MINICONF_INLINE void Config::appendLog(std::string&)
+    {}
+
+    template <typename Part, typename... Parts>
+    void Config::appendLog(std::string& out, const Part& part, const Parts&... parts)
+    {
+        out += logPart(part);
+        appendLog(out, parts...);
+    }
+
+    MINICONF_INLINE const char* Config::logPart(const char* part)
+    {
+        return part;
+    }
+
+    MINICONF_INLINE const char* Config::logPart(char* part)
+    {
+        return part;
+    }
+
+    MINICONF_INLINE const std::string& Config::logPart(const std::string& part)
+    {
+        return part;
+    }
+
+    template <typename Number>
+    std::string Config::logPart(const Number& part)
+    {
+        return std::to_string(part);
+    }
+
+    MINICONF_INLINE void Config::addLog(Config::LogLevel logType, const std::string& token, const std::string& msg)
+    {
+        const int tagWidth = 16;
+        char tag[tagWidth + 1];
+        char format[tagWidth + 1];
+        std::string logString = "";
+        snprintf(format, tagWidth, "<<<%%%ds>>>", tagWidth - 7);
+        switch (logType) {
+            case Config::LogLevel::INFO:
+                snprintf(tag, tagWidth, format, "INFO");
+                break;
+            case Config::LogLevel::WARNING:
+                snprintf(tag, tagWidth, format, "WARNING");
+                break;
+            case Config::LogLevel::ERROR:
+                snprintf(tag, tagWidth, format, "ERROR");
+                break;
+            default:
+                break;
+        }
+        logString = std::string(tag) + " Input \"" + token + "\" : " + msg;
+        _log.emplace_back(logString);
+        if (_verbose) {
+            fprintf(stdout, "%s\n", logString.c_str());
+        }
+    }
+
+    MINICONF_INLINE Config::TokenType Config::getTokenType(const char* token)
+    {
+        // get token type:
+        // starts with "--" - flag
+        // starts with "-" - shortflag/value
+        // otherwise value
+        size_t tlen = strlen(token);
+        if (tlen == 0) return TokenType::UNKNOWN;
+        if (token[0] == '-') {
+            // check if it can be converted to a number
+            char* endptr = nullptr;
+            std::strtod(token, &endptr);
+            if (*endptr == '\0' && endptr != token) {
+                return TokenType::VALUE;
+            }
+            return (token[1] == '-') ? TokenType::FLAG : TokenType::SHORTFLAG;
+        }
+        return TokenType::VALUE;
+    }
+
+    MINICONF_INLINE uint32_t Config::translateShortflag(const char* shortflag, size_t length)
+    {
+        return _options->findShortflag(shortflag, length);
+    }
+
+    MINICONF_INLINE bool Config::findOption(const std::string& flag)
+    {
+        return (_options->find(flag.data(), flag.size()) != OptionTable::NONE);
+    }
+
+    MINICONF_INLINE uint32_t Config::getOption(const char* token, Config::TokenType tokenType)
+    {
+        if (tokenType == TokenType::SHORTFLAG && token[1] != '\0') {
+            // an unknown short flag is looked up as a long flag, e.g. "-port 80"
+            size_t length = strlen(token + 1);
+            uint32_t row = resolveOption(token + 1, length, true);
+            return (row != OptionTable::NONE) ? row : resolveOption(token + 1, length, false);
+        }
+        if (tokenType == TokenType::FLAG && token[2] != '\0') {
+            return resolveOption(token + 2, strlen(token + 2), false);
+        }
+        return OptionTable::NONE;
+    }
+
+    MINICONF_INLINE uint32_t Config::resolveOption(const char* flag, size_t length, bool shortflag)
+    {
+        if (_flagTable) {
+            int index = _flagTable->find(flag, length, shortflag);
+            if (index >= 0 && static_cast<size_t>(index) < _flagTable->size) {
+                if (_flagTableOptions.empty()) {
+                    _flagTableOptions.assign(_flagTable->size, static_cast<uint32_t>(OptionTable::NONE));
+                }
+                // the option is searched only once
+                uint32_t& row = _flagTableOptions[index];
+                if (row == OptionTable::NONE) {
+                    row = _options->find(_flagTable->flags[index], strlen(_flagTable->flags[index]));
+                }
+                if (row != OptionTable::NONE) {
+                    return row;
+                }
+            }
+        }
+        // options which are not in the table
+        if (shortflag) {
+            return translateShortflag(flag, length);
+        }
+        return _options->find(flag, length);
+    }
+
+    MINICONF_INLINE uint32_t Config::FlagTable::hash(const char* flag, size_t length, uint32_t seed)
+    {
+        // FNV-1a with a seed, followed by a final mix
+        uint32_t h = 2166136261u ^ (seed * 0x9E3779B9u);
+        for (size_t i = 0; i < length; ++i) {
+            h ^= static_cast<unsigned char>(flag[i]);
+            h *= 16777619u;
+        }
+        h ^= h >> 16;
+        h *= 0x85EBCA6Bu;
+        h ^= h >> 13;
+        return h;
+    }
+
+    MINICONF_INLINE void Config::flagTable(const FlagTable* table)
+    {
+        _flagTable = table;
+        _flagTableOptions.clear();
+    }
+
+    namespace detail
+    {
+        inline Config::LogLevel worseLevel(const Config::LogLevel& a, const Config::LogLevel& b)
+        {
+            return ((a) < (b)) ? (b) : (a);
+        }
+
+        // compares a numeric value with a bound, returns -1, 0 or 1, or 2 for a NaN value. values
+        // which are not numbers are not compared, they are equal to any bound
+        inline int compareBound(const Value& value, double bound);
+
+        inline int compareBound(const Value& value, int64_t bound)
+        {
+            switch (value.type()) {
+                case Value::DataType::INT:
+                case Value::DataType::INT64:
+                case Value::DataType::DURATION: {
+                    int64_t v = value.getInt64();
+                    return (v > bound) - (v < bound);
+                }
+                case Value::DataType::UINT64:
+                case Value::DataType::BYTES: {
+                    uint64_t v = value.getUInt64();
+                    if (bound < 0 || v > static_cast<uint64_t>(INT64_MAX)) {
+                        return 1;
+                    }
+                    return (static_cast<int64_t>(v) > bound) - (static_cast<int64_t>(v) < bound);
+                }
+                case Value::DataType::NUMBER:
+                    return compareBound(value, static_cast<double>(bound));
+                default:
+                    return 0;
+            }
+        }
+
+        inline int compareBound(const Value& value, double bound)
+        {
+            double v;
+            switch (value.type()) {
+                case Value::DataType::INT:
+                case Value::DataType::INT64:
+                case Value::DataType::DURATION:
+                    v = static_cast<double>(value.getInt64());
+                    break;
+                case Value::DataType::UINT64:
+                case Value::DataType::BYTES:
+                    v = static_cast<double>(value.getUInt64());
+                    break;
+                case Value::DataType::NUMBER:
+                    v = value.getNumber();
+                    break;
+                default:
+                    return 0;
+            }
+            return (v > bound) ? 1 : ((v < bound) ? -1 : ((v == bound) ? 0 : 2));
+        }
+    }
+
+    // Validator
+    MINICONF_INLINE Config::Validator::Validator(std::shared_ptr<const OptionTable> options) : _options(std::move(options))
+    {
+        const OptionTable& table = *_options;
+        // a constrained option has up to 6 instructions
+        _instructions.reserve(table.rows() + 5 * table.constraints().size());
+        for (uint32_t row = 0; row < table.rows(); ++row) {
+            if (table.removed(row) || table.hidden(row)) {
+                continue;
+            }
+            append(Op::DEFINED, row).integer = 0;
+            const std::shared_ptr<const Constraints>& constraints = table.constraints(row);
+            if (!constraints) {
+                continue;
+            }
+            bound(row, constraints->minimum, true);
+            bound(row, constraints->maximum, false);
+            if (constraints->minLength > 0) {
+                append(Op::MIN_LENGTH, row).length = constraints->minLength;
+            }
+            if (constraints->maxLength < SIZE_MAX) {
+                append(Op::MAX_LENGTH, row).length = constraints->maxLength;
+            }
+#ifndef MINICONF_LEAN
+            if (constraints->regex) {
+                append(Op::PATTERN, row).pattern = _patterns.size();
+                _patterns.push_back(constraints->regex);
+            }
+#endif
+        }
+        // hidden options are never set, they are left out of the groups
+        for (auto && g : table.groups()) {
+            std::vector<uint32_t> rows;
+            for (auto && row : g) {
+                if (!table.removed(row) && !table.hidden(row)) {
+                    rows.push_back(row);
+                }
+            }
+            if (rows.size() > 1) {
+                _groups.push_back(std::move(rows));
+            }
+        }
+    }
+
+    MINICONF_INLINE Config::Validator::Instruction& Config::Validator::append(Op op, uint32_t row)
+    {
+        _instructions.emplace_back();
+        _instructions.back().op = op;
+        _instructions.back().row = row;
+        return _instructions.back();
+    }
+
+    MINICONF_INLINE void Config::Validator::bound(uint32_t row, const Value& bound, bool minimum)
+    {
+        Value::DataType type = _options->type(row);
+        bool integral = type == Value::DataType::INT || type == Value::DataType::INT64 || type == Value::DataType::UINT64 || 
+            type == Value::DataType::DURATION || type == Value::DataType::BYTES;
+        double number;
+        switch (bound.type()) {
+            case Value::DataType::INT:
+            case Value::DataType::INT64:
+            case Value::DataType::DURATION:
+                if (integral) {
+                    append(minimum ? Op::MIN_INTEGER : Op::MAX_INTEGER, row).integer = bound.getInt64();
+                    return;
+                }
+                number = static_cast<double>(bound.getInt64());
+                break;
+            case Value::DataType::UINT64:
+            case Value::DataType::BYTES:
+                if (integral && bound.getUInt64() <= static_cast<uint64_t>(INT64_MAX)) {
+                    append(minimum ? Op::MIN_INTEGER : Op::MAX_INTEGER, row).integer = static_cast<int64_t>(bound.getUInt64());
+                    return;
+                }
+                number = static_cast<double>(bound.getUInt64());
+                break;
+            case Value::DataType::NUMBER: {
+                number = bound.getNumber();
+                // integers are compared with the bound rounded inwards, e.g. >= 2.5 is >= 3
+                double rounded = minimum ? ceil(number) : floor(number);
+                if (integral && rounded >= -9223372036854775808.0 && rounded < 9223372036854775808.0) {
+                    append(minimum ? Op::MIN_INTEGER : Op::MAX_INTEGER, row).integer = static_cast<int64_t>(rounded);
+                    return;
+                }
+                break;
+            }
+            default:
+                // no bound, or a bound which is not a number
+                return;
+        }
+        append(minimum ? Op::MIN_NUMBER : Op::MAX_NUMBER, row).number = number;
+    }
+
+    MINICONF_INLINE bool Config::Validator::check(const Instruction& instruction, const Value& value) const
+    {
+        bool text = value.type() == Value::DataType::STRING || value.type() == Value::DataType::CHOICE;
+        int order;
+        switch (instruction.op) {
+            // a NaN value (2) is out of any range
+            case Op::MIN_INTEGER:
+                order = detail::compareBound(value, instruction.integer);
+                return order == 0 || order == 1;
+            case Op::MAX_INTEGER:
+                return detail::compareBound(value, instruction.integer) <= 0;
+            case Op::MIN_NUMBER:
+                order = detail::compareBound(value, instruction.number);
+                return order == 0 || order == 1;
+            case Op::MAX_NUMBER:
+                return detail::compareBound(value, instruction.number) <= 0;
+            case Op::MIN_LENGTH:
+                return !text || value.length() >= instruction.length;
+            case Op::MAX_LENGTH:
+                return !text || value.length() <= instruction.length;
+#ifndef MINICONF_LEAN
+            case Op::PATTERN:
+                return !text || std::regex_match(value.getCharArray(), value.getCharArray() + value.length(), *_patterns[instruction.pattern]);
+#endif
+            default:
+                return true;
+        }
+    }
+
+    MINICONF_INLINE void Config::Validator::run(const Config& config, size_t begin, size_t end, std::vector<Failure>& failures, std::vector<uint8_t>& sources) const
+    {
+        std::string flag;
+        const Value* value = nullptr;
+        for (size_t i = begin; i < end; ++i) {
+            const Instruction& instruction = _instructions[i];
+            if (instruction.op != Op::DEFINED) {
+                if (value && !value->isEmpty() && !check(instruction, *value)) {
+                    failures.push_back(Failure{static_cast<uint32_t>(i), false});
+                }
+                continue;
+            }
+            // values of constrained options are looked up once for all their checks, unconstrained
+            // options are only located, so their lazily loaded values are not converted
+            flag = _options->flag(instruction.row);
+            Source source = Source::NONE;
+            bool constrained = i + 1 < _instructions.size() && _instructions[i + 1].op != Op::DEFINED;
+            value = constrained ? config.lookup(flag, &source) : nullptr;
+            source = constrained ? source : config.locate(flag);
+            if (!sources.empty()) {
+                sources[instruction.row] = static_cast<uint8_t>(source);
+            }
+            if (source == Source::NONE || (source == Source::DEFAULT && _options->defaultValue(instruction.row).isEmpty())) {
+                failures.push_back(Failure{static_cast<uint32_t>(i), source == Source::NONE});
+            }
+        }
+    }
+
+    MINICONF_INLINE size_t Config::Validator::align(size_t instruction) const
+    {
+        while (instruction < _instructions.size() && _instructions[instruction].op != Op::DEFINED) {
+            ++instruction;
+        }
+        return instruction;
+    }
+
+    MINICONF_INLINE Config::LogLevel Config::Validator::run(Config& config) const
+    {
+        // the sources of the values are only needed for the groups
+        std::vector<uint8_t> sources(_groups.empty() ? 0 : _options->rows(), static_cast<uint8_t>(Source::NONE));
+        size_t count = _instructions.size();
+        unsigned int threads = 1;
+        if (count >= PARALLEL_INSTRUCTIONS) {
+            threads = std::max(1u, std::thread::hardware_concurrency());
+            threads = static_cast<unsigned int>(std::min<size_t>(threads, count / (PARALLEL_INSTRUCTIONS / 8)));
+        }
+
+        // each thread runs a range of options, failures are logged in the order of the options
+        std::vector<Failure> failures;
+        std::vector<std::vector<Failure>> parallelFailures(threads - 1);
+        std::vector<std::thread> pool;
+        for (unsigned int t = 1; t < threads; ++t) {
+            pool.emplace_back([&, t]() {
+                run(config, align(count * t / threads), align(count * (t + 1) / threads), parallelFailures[t - 1], sources);
+            });
+        }
+        run(config, 0, align(count / threads), failures, sources);
+        for (auto && t : pool) {
+            t.join();
+        }
+        for (auto && f : parallelFailures) {
+            failures.insert(failures.end(), f.begin(), f.end());
+        }
+
+        LogLevel errorLv = LogLevel::INFO;
+        for (auto && failure : failures) {
+            errorLv = detail::worseLevel(errorLv, report(config, failure));
+        }
+        for (auto && g : _groups) {
+            const char* setFlag = nullptr;
+            std::string missing;
+            for (auto && row : g) {
+                if (sources[row] > static_cast<uint8_t>(Source::DEFAULT)) {
+                    setFlag = setFlag ? setFlag : _options->flag(row);
+                } else {
+                    missing += (missing.empty() ? "" : ", ");
+                    missing += _options->flag(row);
+                }
+            }
+            if (setFlag && !missing.empty()) {
+                config.log(LogLevel::ERROR, setFlag, "option must be set together with: ", missing);
+                errorLv = detail::worseLevel(errorLv, LogLevel::ERROR);
+            }
+        }
+        return errorLv;
+    }
+
+    MINICONF_INLINE Config::LogLevel Config::Validator::report(Config& config, const Failure& failure) const
+    {
+        // the message is only built if it is kept
+        if (!config.logEnabled(LogLevel::ERROR)) {
+            return LogLevel::ERROR;
+        }
+        const Instruction& instruction = _instructions[failure.instruction];
+        std::string flag = _options->flag(instruction.row);
+        if (instruction.op == Op::DEFINED) {
+            config.log(LogLevel::ERROR, flag, failure.undefined ? "option is undefined" : "option contains invalid value");
+            return LogLevel::ERROR;
+        }
+        const Value* value = config.lookup(flag);
+        std::string shown = value ? value->print() : std::string();
+        const Constraints& constraints = *(_options->constraints(instruction.row));
+        switch (instruction.op) {
+            case Op::MIN_INTEGER:
+            case Op::MIN_NUMBER:
+                config.log(LogLevel::ERROR, flag, "value ", shown, " is less than the minimum ", constraints.minimum.print());
+                break;
+            case Op::MAX_INTEGER:
+            case Op::MAX_NUMBER:
+                config.log(LogLevel::ERROR, flag, "value ", shown, " is greater than the maximum ", constraints.maximum.print());
+                break;
+            case Op::MIN_LENGTH:
+                config.log(LogLevel::ERROR, flag, "value ", shown, " is shorter than ", constraints.minLength, " characters");
+                break;
+            case Op::MAX_LENGTH:
+                config.log(LogLevel::ERROR, flag, "value ", shown, " is longer than ", constraints.maxLength, " characters");
+                break;
+#ifndef MINICONF_LEAN
+            case Op::PATTERN:
+                config.log(LogLevel::ERROR, flag, "value ", shown, " does not match the pattern \"", constraints.pattern, "\"");
+                break;
+#endif
+            default:
+                break;
+        }
+        return LogLevel::ERROR;
+    }
+
+    // Schema
+    MINICONF_INLINE Config::Schema::Schema() :
+        _format(LogLevel::INFO),
+        _verbose(false),
+        _logLevel(LogLevel::WARNING),
+        _autoHelp(true),
+        _loadConfig(true),
+        _lazyLoading(false),
+        _flagTable(nullptr)
     {}
 
-    Config::Option::~Option()
-    {}
+    MINICONF_INLINE Config::LogLevel Config::Schema::format() const
+    {
+        return _format;
+    }
+
+    MINICONF_INLINE size_t Config::Schema::size() const
+    {
+        // the table of a schema is a copy, which has no removed rows
+        return _options->rows();
+    }
+
+    MINICONF_INLINE bool Config::Schema::contains(const std::string& flag) const
+    {
+        return _options->find(flag.data(), flag.size()) != OptionTable::NONE;
+    }
+
+    MINICONF_INLINE const std::string& Config::Schema::description() const
+    {
+        return _description;
+    }
+
+    MINICONF_INLINE Config::LogLevel Config::checkFormat()
+    {
+        LogLevel errorLv = LogLevel::INFO;
+        const OptionTable& options = *_options;
+        for (uint32_t row = 0; row < options.rows(); ++row) {
+            if (options.removed(row)) {
+                continue;
+            }
+            // check for error
+            if (!options.required(row) && options.defaultValue(row).isEmpty()) {
+                log(LogLevel::ERROR, options.flag(row), "default value is not defined");
+                errorLv = detail::worseLevel(errorLv, LogLevel::ERROR);
+            }
+            // duplicates are marked when the short flags are indexed
+            if (options.duplicateShortflag(row)) {
+                log(LogLevel::ERROR, options.flag(row), "duplicate short flags (", options.shortflag(row), ")");
+                errorLv = detail::worseLevel(errorLv, LogLevel::ERROR);
+            }
+#ifndef MINICONF_LEAN
+            const std::shared_ptr<const Constraints>& constraints = options.constraints(row);
+            if (constraints && !constraints->pattern.empty() && !constraints->regex) {
+                log(LogLevel::ERROR, options.flag(row), "invalid pattern \"", constraints->pattern, "\"");
+                errorLv = detail::worseLevel(errorLv, LogLevel::ERROR);
+            }
+#endif
+            // check for warnings
+            if (options.description(row)[0] == '\0') {
+                log(LogLevel::WARNING, options.flag(row), "no description text for argument");
+                errorLv = detail::worseLevel(errorLv, LogLevel::WARNING);
+            }
+            if (options.shortflag(row)[0] == '\0') {
+                log(LogLevel::WARNING, options.flag(row), "no short flag is provided");
+                errorLv = detail::worseLevel(errorLv, LogLevel::WARNING);
+            }
+        }
+        if (programDescription().empty()) {
+            log(LogLevel::WARNING, "", "No program description text is provided");
+            errorLv = detail::worseLevel(errorLv, LogLevel::WARNING);
+        }
+        return errorLv;
+    }
+
+    // Validate User Input
+    MINICONF_INLINE Config::LogLevel Config::validate()
+    {
+        LogLevel errorLv = LogLevel::INFO;
+
+        // remove all the hidden values
+        const OptionTable& options = *_options;
+        for (uint32_t row = 0; row < options.rows(); ++row) {
+            if (!options.removed(row) && options.hidden(row)) {
+                for (auto && l : _layers) {
+                    l.erase(options.flag(row));
+                }
+            }
+        }
+
+        // scan for all option vlaues which are not shadowed by another layer
+        for (int i = 0; i < LAYERS; ++i) {
+            for (auto && val : _layers[i]) {
+                if (val.second.isEmpty() && locate(val.first) == static_cast<Source>(i + static_cast<int>(Source::CONFIG))) {
+                    log(LogLevel::ERROR, val.first, "option contains invalid value");
+                    errorLv = detail::worseLevel(errorLv, LogLevel::ERROR);
+                }
+            }
+        }
+
+        // check that all the remaining options are defined and meet their constraints, the program
+        // shares the option table, so it is compiled again after the options are modified
+        if (!_validator || _validator->_options != _options) {
+            _validator = std::make_shared<Validator>(_options);
+        }
+        return detail::worseLevel(errorLv, _validator->run(*this));
+    }
+
+    MINICONF_INLINE bool Config::parse(int argc, char **argv)
+    {
+        // Extract executable name
+        _exeName = std::string(argv[0]);
+        size_t lastslash = _exeName.find_last_of("\\/");
+        if (lastslash != std::string::npos) {
+            _exeName = _exeName.substr(lastslash + 1);
+        }
+
+        // check format of the option parser, the format of a schema is checked once when it is built
+        // if fatal error occurs and log level is not "NONE" (NONE = ignore errors)
+        LogLevel checkFormatResult = (_schema && _schema->_options == _options) ? _schema->_format : checkFormat();
+        if (checkFormatResult >= LogLevel::ERROR && _logLevel <= LogLevel::ERROR) {
+            log();
+            printf("\nFatal Error: Option format validation failed, abort.\n\n");
+            return false;
+        }
+
+        // Value Precedence:
+        // (1) Default Value
+        // (2) Config File Settings (overwrites default values)
+        // (3) Command Line Arguments (overwrites default values and config file)
+
+        // * Default values are not copied, previously parsed values are cleared, loaded files are kept
+        layer(Source::COMMAND_LINE).clear();
+        lazyLayer(Source::COMMAND_LINE).clear();
+
+        // * Load Config File before scanning for other arguments
+        // case 1: only config file is defined, flag is not necessary
+        // case 2: check if config flag has been defined
+        if (_loadConfig) {
+            for (int i = 1; i < argc - 1; ++i) {
+                bool isConfigFlag = (strcmp(argv[i], "--config") == 0 || strcmp(argv[i], "-cfg") == 0);
+                if (isConfigFlag && getTokenType(argv[i + 1]) == TokenType::VALUE) {
+                    config(argv[i + 1], Source::CONFIG);
+                }
+            }
+        }
+
+        // start normal parsing
+        // the current flag points into the option table or into argv
+        const char* currentFlag = nullptr;
+        Value::DataType currentType = Value::DataType::STRING;
+        for (int i = 1; i < argc; ++i) {
+            TokenType currentTokenType = getTokenType(argv[i]);
+            if (currentTokenType == TokenType::UNKNOWN) {
+                log(LogLevel::ERROR, argv[i], "unknown input");
+            } else if (currentTokenType == TokenType::FLAG || currentTokenType == TokenType::SHORTFLAG) {
+                uint32_t row = getOption(argv[i], currentTokenType);
+                currentFlag = nullptr;
+                if (row != OptionTable::NONE) {
+                    currentFlag = _options->flag(row);
+                    currentType = _options->type(row);
+                } else {
+                    log(LogLevel::WARNING, argv[i], "unrecognized flag");
+                    // a wildcard captures "stray" option values, string argument by default
+                    if (currentTokenType == TokenType::FLAG) {
+                        currentFlag = argv[i] + 2;
+                        currentType = Value::DataType::STRING;
+                    }
+                }
+                // special case - if the option type is bool, set to true by default
+                if (currentFlag && currentType == Value::DataType::BOOL) {
+                    layer(Source::COMMAND_LINE)[currentFlag] = true;
+                }
+            } else if (currentTokenType == TokenType::VALUE) {
+                if (currentFlag) {
+                    // parse the value according to default data type
+                    Value newValue = Value::parse(argv[i], currentType);
+                    // if value cannot be parsed
+                    if (newValue.isEmpty()) {
+                        log(LogLevel::WARNING, argv[i], "unvalid value type is provided");
+                    } else {
+                        // assign parsed values
+                        layer(Source::COMMAND_LINE)[currentFlag] = std::move(newValue);
+                        log(LogLevel::INFO, argv[i], "value parsed successfully");
+                    }
+                    // reset current option flag -> ready for a new flag
+                    currentFlag = nullptr;
+                } else {
+                    // stray arguments, ignore
+                    log(LogLevel::WARNING, argv[i], "unassociated argument is not stored");
+                }
+            }
+        }
+
+        // resolve choices to their codes
+        LogLevel choiceResult = resolveChoices(Source::COMMAND_LINE);
+
+        // if contains help and auto-help is enabled, display help message
+        const Value* helpValue = lookup("help");
+        if (helpValue && !helpValue->isEmpty() && helpValue->getBoolean() && _autoHelp) {
+            help();
+        }
+
+        // validate user inputs
+        // remove all hidden options
+        // reserved words should not be displayed as normal config values
+
+        // if fatal error occurs and log level is not "NONE" (NONE = ignore errors)
+        // an invalid choice on the command line is rejected as well
+        LogLevel validateResult = detail::worseLevel(validate(), choiceResult);
+        if (validateResult >= LogLevel::ERROR && _logLevel <= LogLevel::ERROR) {
+            log();
+            printf("\nFatal Error: Option format validation failed, abort.\n\n");
+            return false;
+        }
+
+        return true;
+    }
+
+    MINICONF_INLINE void Config::help(FILE* fd)
+    {
+        // print program description
+        const std::string& description = programDescription();
+        if (!description.empty()) {
+            fprintf(fd, "\n");
+            if (!_exeName.empty()) {
+                fprintf(fd, "[[[  %s  ]]]\n\n    ", _exeName.c_str());
+            }
+            fprintf(fd, "%s\n\n", description.c_str());
+        }
+
+        // print usage
+        usage(fd);
+        // print help
+        fprintf(fd, "\n[[[  %s  ]]]\n\n", "HELP");
+        const OptionTable& options = *_options;
+        for (uint32_t row : options.sorted()) {
+            // print short
+            fprintf(fd, "    ");
+            if (options.shortflag(row)[0] != '\0') {
+                fprintf(fd, "-%s, ", options.shortflag(row));
+            }
+            // print long
+            fprintf(fd, "--%s ", options.flag(row));
+            // required
+            if (options.required(row)) {
+                fprintf(fd, "<REQUIRED>");
+            }
+            fprintf(fd, "\n");
+            // print description
+            fprintf(fd, "        ");
+            if (options.description(row)[0] != '\0') {
+                fprintf(fd, "%s ", options.description(row));
+            }
+            // default value
+            if (!options.defaultValue(row).isEmpty() && !options.hidden(row)) {
+                fprintf(fd, " ( ");
+                fprintf(fd, "DEFAULT = %s", options.defaultValue(row).print().c_str());
+                fprintf(fd, " ) ");
+            }
+            // allowed values
+            if (options.choices(row)) {
+                fprintf(fd, " ( CHOICES = %s ) ", options.choices(row)->list().c_str());
+            }
+            fprintf(fd, "\n\n");
+        }
+    }
+
+    MINICONF_INLINE void Config::usage(FILE* fd)
+    {
+        fprintf(fd, "\n[[[  %s  ]]]\n\n", "USAGE");
+        char exeTag[256];
+        snprintf(exeTag, 256 - 1, "    %s ", (_exeName.empty()) ? ("<executable>") : (_exeName.c_str()));
+        fprintf(fd, "%s", exeTag);
+        int lineWidth = 0;
+        const OptionTable& options = *_options;
+        for (uint32_t row : options.sorted()) {
+            bool required = options.required(row);
+            const char* shortflag = options.shortflag(row);
+            char argTag[512];
+            snprintf(argTag, 512 - 1, "%s%s%s <%s>%s",
+                    required ? "" : "[",
+                    (shortflag[0] == '\0') ? "--" : "-",
+                    (shortflag[0] == '\0') ? options.flag(row) : shortflag,
+                    options.defaultValue(row).printType().c_str(),
+                    required ? "" : "]");
+            if (lineWidth + strlen(argTag) >= 80 - 1 - strlen(exeTag)) {
+                fprintf(fd, "\n%*s", static_cast<int>(strlen(exeTag)), " ");
+                lineWidth = 0;
+            }
+            fprintf(fd, "%s ", argTag);
+            lineWidth += strlen(argTag);
+        }
+        fprintf(fd, "\n\n");
+    }
+
+    MINICONF_INLINE void Config::description(const std::string& desc)
+    {
+        _description = desc;
+    }
+
+    MINICONF_INLINE void Config::enableConfig(bool enabled)
+    {
+        _loadConfig = enabled;
+        if (_autoHelp && !findOption("config")) {
+            option("config").
+                shortflag("cfg").
+                defaultValue("").
+                description("Input configuration file (JSON/CSV)").
+                required(false).hidden(true);
+        } else {
+            if (findOption("config")) {
+                remove("config");
+            }
+        }
+
+    }
+
+    MINICONF_INLINE void Config::enableLazyLoading(bool enabled)
+    {
+        _lazyLoading = enabled;
+    }
+
+    MINICONF_INLINE void Config::enableHelp(bool enabled)
+    {
+        _autoHelp = enabled;
+        if (_autoHelp && !findOption("help")) {
+            option("help").
+                shortflag("h").
+                defaultValue(false).
+                description("Display the help message").
+                required(false).hidden(true);
+        } else {
+            if (findOption("help")) {
+                remove("help");
+            }
+        }
+    }
+
+    MINICONF_INLINE void Config::verbose(bool value)
+    {
+        _verbose = value;
+    }
+
+    MINICONF_INLINE bool Config::contains(const std::string& flag)
+    {
+        return locate(flag) != Source::NONE;
+    }
+
+    MINICONF_INLINE Config::Reference Config::operator[](const std::string& flag)
+    {
+        return Reference(*this, flag, lookup(flag));
+    }
+
+    MINICONF_INLINE Value& Config::modifiable(const std::string& flag)
+    {
+        Source source = Source::NONE;
+        const Value* found = lookup(flag, &source);
+        if (source == Source::NONE || source == Source::DEFAULT) {
+            // copy on write, default values are never modified
+            Value& newValue = layer(Source::USER)[flag];
+            if (found) {
+                newValue = *found;
+            }
+            return newValue;
+        }
+        // lazily loaded values are copied to the layer before modified
+        auto& values = layer(source);
+        auto inLayer = values.find(flag);
+        if (inLayer == values.end()) {
+            inLayer = values.emplace(flag, *found).first;
+        }
+        return inLayer->second;
+    }
 
-    Config::Option& Config::Option::flag(const std::string& flag)
+    MINICONF_INLINE const Value& Config::value(const std::string& flag) const
     {
-        _flag = flag;
-        return *this;
+        static const Value empty;
+        const Value* found = lookup(flag);
+        return found ? *found : empty;
     }
 
-    Config::Option& Config::Option::shortflag(const std::string& shortflag)
+    MINICONF_INLINE Config::Source Config::source(const std::string& flag) const
     {
-        _shortflag = shortflag;
-        return *this;
+        return locate(flag);
     }
 
-    Config::Option& Config::Option::description(const std::string& description)
+    MINICONF_INLINE bool Config::swapLayer(Source source, std::map<std::string, Value>& values)
     {
-        _description = description;
-        return *this;
+        if (source == Source::NONE || source == Source::DEFAULT) {
+            return false;
+        }
+        // lazily loaded values are converted and moved to the layer first
+        auto& lazyValues = lazyLayer(source);
+        for (auto lazy = lazyValues.rbegin(); lazy != lazyValues.rend(); ++lazy) {
+            for (size_t index = 0; index < (*lazy)->size(); ++index) {
+                layer(source).emplace((*lazy)->flag(index), (*lazy)->value(index));
+            }
+        }
+        lazyValues.clear();
+        layer(source).swap(values);
+        return true;
     }
 
-    Config::Option& Config::Option::defaultValue(const Value& defaultValue)
+    MINICONF_INLINE void Config::environment(const std::string& prefix)
     {
-        _defaultValue = defaultValue;
-        return *this;
+        const OptionTable& options = *_options;
+        for (uint32_t row = 0; row < options.rows(); ++row) {
+            if (options.removed(row) || options.hidden(row)) {
+                continue;
+            }
+            const char* flag = options.flag(row);
+            std::string name = prefix + flag;
+            for (size_t i = prefix.size(); i < name.size(); ++i) {
+                name[i] = isalnum(static_cast<unsigned char>(name[i])) ? toupper(static_cast<unsigned char>(name[i])) : '_';
+            }
+            const char* envValue = getenv(name.c_str());
+            if (envValue) {
+                Value newValue = Value::parse(envValue, options.type(row));
+                if (newValue.isEmpty()) {
+                    log(LogLevel::WARNING, name, "unvalid value type is provided");
+                } else {
+                    layer(Source::ENVIRONMENT)[flag] = std::move(newValue);
+                    log(LogLevel::INFO, name, "value is loaded from environment");
+                }
+            }
+        }
+        resolveChoices(Source::ENVIRONMENT);
     }
 
-    Config::Option& Config::Option::defaultValue(const int& defaultValue)
+    MINICONF_INLINE void Config::print(FILE* fd)
     {
-        _defaultValue = static_cast<int>(defaultValue);
-        return *this;
+        fprintf(fd, "\n[[[  %s  ]]]\n\n", "CONFIGURATION");
+
+        printf("|-------------------------|------------|--------------------------------------------------|\n");
+        printf("|           NAME          |    TYPE    |                     VALUE                        |\n");
+        printf("|-------------------------|------------|--------------------------------------------------|\n");
+        std::map<std::string, const Value*> allValues;
+        values(allValues);
+        for (auto && v : allValues) {
+            if (_options->find(v.first.data(), v.first.size()) != OptionTable::NONE) {
+                fprintf(fd, "| %-23s | %-10s | %-48s |\n", v.first.c_str(), v.second->printType().c_str(), v.second->print().c_str());
+            } else {
+                fprintf(fd, "| %-23s | %-10s | %-48s |\n", v.first.c_str(), (v.second->printType() + "*").c_str(), v.second->print().c_str());
+            }
+        }
+        printf("|-------------------------|------------|--------------------------------------------------|\n");
+        printf("\n");
+    }
+
+    MINICONF_INLINE std::string Config::serialize(const std::string& serializeFilePath, ExportFormat format, bool pretty)
+    {
+        std::string outStr;
+
+        // extract extension
+        std::string extension = "";
+        size_t lastDot = serializeFilePath.find_last_of(".");
+        if (lastDot != std::string::npos) {
+            extension = serializeFilePath.substr(lastDot + 1);
+        }
+#ifdef MINICONF_JSON_SUPPORT
+        if (extension == "json" || extension == "JSON"){
+            format = ExportFormat::JSON; 
+        } else if (extension == "csv" || extension == "CSV"){
+            format = ExportFormat::CSV; 
+        } else {
+            format = ExportFormat::CSV; 
+        }
+#else
+        format = ExportFormat::CSV; 
+#endif
+
+        std::map<std::string, const Value*> allValues;
+        values(allValues);
+
+        // serialize JSON
+#ifdef MINICONF_JSON_SUPPORT
+        if (format == ExportFormat::JSON) {
+            picojson::value outObj = picojson::value(picojson::object());
+            for (auto && v : allValues){
+                std::vector<std::string> flagTokens;
+                // tokenize
+                for (size_t tokenStart = 0; ; ) {
+                    size_t tokenEnd = v.first.find('.', tokenStart);
+                    flagTokens.emplace_back(v.first, tokenStart, tokenEnd - tokenStart);
+                    if (tokenEnd == std::string::npos) {
+                        break;
+                    }
+                    tokenStart = tokenEnd + 1;
+                }
+                // parse
+                if (flagTokens.size() > 1){
+                    picojson::value* thisObj = &outObj;
+                    for (size_t i = 0; i < flagTokens.size(); ++i){
+                        if (i != flagTokens.size() - 1){
+                            if (thisObj->get<picojson::object>().find(flagTokens[i]) == thisObj->get<picojson::object>().end()){
+                                thisObj->get<picojson::object>()[flagTokens[i]] = picojson::value(picojson::object());
+                            }
+                            thisObj = &(thisObj->get<picojson::object>()[flagTokens[i]]);
+                        } else {
+                            if (!v.second->isEmpty()){
+                                thisObj->get<picojson::object>()[flagTokens[i]] = toJSONValue(*v.second);
+                            }
+                        }
+                    }
+                }else{
+                    if (outObj.get<picojson::object>().find(flagTokens[0]) == outObj.get<picojson::object>().end()){
+                        if (!v.second->isEmpty()){
+                            outObj.get<picojson::object>()[flagTokens[0]] = toJSONValue(*v.second);
+                        }
+                    }
+                }
+            }
+            outStr = outObj.serialize(pretty);
+        }
+#endif
+
+        // serialize CSV
+        if (format == ExportFormat::CSV) {
+            for (auto opt = std::begin(allValues); opt != std::end(allValues); ++opt) {
+                std::string flag = opt->first;
+                std::string val = opt->second->print();
+                if (opt->second->type() == Value::DataType::STRING || opt->second->type() == Value::DataType::CHOICE){
+                    // remove "" from string
+                    if (val.size() >= 2){ 
+                        val = val.substr(1, val.size()-2);
+                    }
+                }
+                outStr += flag + "," + val + "\n"; 
+            }
+        }
+
+        // write out file
+        if (!serializeFilePath.empty()) {
+            FILE* fd = fopen(serializeFilePath.c_str(), "w");
+            if (fd) {
+                fwrite(outStr.data(), 1, outStr.size(), fd);
+                fclose(fd);
+            }
+        }
+        return outStr;
+    }
+
+    MINICONF_INLINE bool Config::config(const std::string& configPath, Source source)
+    {
+        return config(configPath, "", source);
+    }
+
+    MINICONF_INLINE bool Config::config(const std::string& configPath, const std::string& prefix, Source source)
+    {
+        const std::vector<std::string> path = splitPrefix(prefix);
+
+        // default values are never loaded from a file
+        if (source == Source::NONE || source == Source::DEFAULT) {
+            source = Source::CONFIG;
+        }
+
+        // read content of the file
+        std::string configContent = "";
+        if (!readFile(configPath, configContent)) {
+            log(LogLevel::ERROR, configPath, "config file cannot be read");
+            return false;
+        }
+
+        // extract extension
+        std::string extension = "";
+        size_t lastDot = configPath.find_last_of(".");
+        if (lastDot != std::string::npos) {
+            extension = configPath.substr(lastDot + 1);
+        }
+
+        // load config according to extension
+        // default is json
+#ifdef MINICONF_JSON_SUPPORT
+        ExportFormat format = (extension == "csv" || extension == "CSV") ? ExportFormat::CSV : ExportFormat::JSON;
+#else
+        ExportFormat format = ExportFormat::CSV;
+#endif
+        bool success = true;
+        if (_lazyLoading) {
+            success = loadLazy(std::move(configContent), format, path, source);
+#ifdef MINICONF_JSON_SUPPORT
+        } else if (format == ExportFormat::JSON) {
+            success = loadJSON(configContent, path, source);
+#endif
+        } else {
+            success = loadCSV(configContent, path, source);
+        }
+        if (!success) {
+            log(LogLevel::ERROR, configPath, "config file is not valid");
+        }
+        resolveChoices(source);
+        return success;
+    }
+
+    MINICONF_INLINE std::vector<Config> Config::loadMany(const std::vector<std::string>& paths, const Config& schema, unsigned int threads)
+    {
+        std::vector<LogLevel> status;
+        return loadMany(paths, schema, status, threads);
+    }
+
+    MINICONF_INLINE std::vector<Config> Config::loadMany(const std::vector<std::string>& paths, const Config& schema, 
+        std::vector<LogLevel>& status, unsigned int threads)
+    {
+        // all the results share the option map and the validation program of the schema
+        std::vector<Config> results(paths.size(), schema);
+        if (!schema._validator || schema._validator->_options != schema._options) {
+            std::shared_ptr<const Validator> validator = std::make_shared<Validator>(schema._options);
+            for (auto && r : results) {
+                r._validator = validator;
+            }
+        }
+        if (threads == 0) {
+            threads = std::max(1u, std::thread::hardware_concurrency());
+        }
+        threads = static_cast<unsigned int>(std::min<size_t>(threads, paths.size()));
+        status.assign(paths.size(), LogLevel::INFO);
+
+        // workers pick the next unloaded file until all files are taken
+        std::atomic<size_t> next(0);
+        auto worker = [&]() {
+            for (size_t i = next++; i < paths.size(); i = next++) {
+                Config& conf = results[i];
+                status[i] = conf.config(paths[i], Source::CONFIG) ? conf.validate() : LogLevel::ERROR;
+            }
+        };
+
+        std::vector<std::thread> pool;
+        for (unsigned int t = 1; t < threads; ++t) {
+            pool.emplace_back(worker);
+        }
+        worker();
+        for (auto && t : pool) {
+            t.join();
+        }
+        return results;
+    }
+
+    MINICONF_INLINE bool Config::readFile(const std::string& path, std::string& content)
+    {
+        FILE* fd = fopen(path.c_str(), "rb");
+        if (!fd) {
+            return false;
+        }
+        // reserve the size of regular files, others are read until the end
+        if (fseek(fd, 0, SEEK_END) == 0) {
+            long size = ftell(fd);
+            if (size > 0) {
+                content.reserve(content.size() + static_cast<size_t>(size));
+            }
+            fseek(fd, 0, SEEK_SET);
+        }
+        char buffer[4096];
+        size_t count;
+        while ((count = fread(buffer, 1, sizeof(buffer), fd)) > 0) {
+            content.append(buffer, count);
+        }
+        fclose(fd);
+        return true;
+    }
+
+    MINICONF_INLINE std::vector<std::string> Config::splitPrefix(const std::string& prefix)
+    {
+        std::vector<std::string> keys;
+        if (prefix.empty()) {
+            return keys;
+        }
+        if (prefix[0] != '/') {
+            // dotted prefix
+            size_t start = 0;
+            for (size_t dot = prefix.find('.'); dot != std::string::npos; start = dot + 1, dot = prefix.find('.', start)) {
+                keys.emplace_back(prefix.substr(start, dot - start));
+            }
+            keys.emplace_back(prefix.substr(start));
+            return keys;
+        }
+        // JSON Pointer, "~1" and "~0" are escaped "/" and "~"
+        for (size_t i = 0; i < prefix.size(); ++i) {
+            if (prefix[i] == '/') {
+                keys.emplace_back();
+            } else if (prefix[i] == '~' && i + 1 < prefix.size() && (prefix[i + 1] == '0' || prefix[i + 1] == '1')) {
+                keys.back().push_back((prefix[++i] == '0') ? '~' : '/');
+            } else {
+                keys.back().push_back(prefix[i]);
+            }
+        }
+        return keys;
+    }
+
+    MINICONF_INLINE bool Config::loadCSV(const std::string& CSVStr, const std::vector<std::string>& path, Source source)
+    {
+        // flags are loaded if they are equal to the prefix, or start with the prefix and a dot
+        std::string prefix;
+        for (auto && key : path) {
+            prefix += (prefix.empty() ? "" : ".") + key;
+        }
+        const char* data = CSVStr.data();
+        bool success = true;
+        std::string sflag;
+        std::string svalue;
+        for (size_t lineStart = 0; lineStart < CSVStr.size(); ) {
+            size_t lineEnd = std::find(data + lineStart, data + CSVStr.size(), '\n') - data;
+            // each line is a list of flags and values separated by commas
+            for (size_t flagStart = lineStart; flagStart < lineEnd; ) {
+                size_t flagEnd = std::find(data + flagStart, data + lineEnd, ',') - data;
+                size_t valueStart = std::min(flagEnd + 1, lineEnd);
+                size_t valueEnd = std::find(data + valueStart, data + lineEnd, ',') - data;
+                sflag.assign(data + flagStart, flagEnd - flagStart);
+                svalue.assign(data + valueStart, valueEnd - valueStart);
+                flagStart = valueEnd + 1;
+                if (svalue.empty()){
+                    continue; 
+                }
+                if (!prefix.empty() && sflag.compare(0, prefix.size(), prefix) != 0) {
+                    continue;
+                }
+                if (!prefix.empty() && sflag.size() > prefix.size() && sflag[prefix.size()] != '.') {
+                    continue;
+                }
+                // check if options exists
+                uint32_t row = resolveOption(sflag.c_str(), sflag.size(), false);
+                if (row != OptionTable::NONE){
+                    // parse the default data type
+                    layer(source)[sflag] = Value::parse(svalue.c_str(), _options->type(row)); 
+                    log(LogLevel::INFO, sflag, "value is loaded from config");
+                } else {
+                    // parse string when the flag does not exist in the original configuration
+                    layer(source)[sflag] = Value::parse(svalue.c_str(), Value::DataType::STRING);
+                    log(LogLevel::INFO, sflag, "value is not defined in config, parsed as a string value");
+                }
+            }
+            lineStart = lineEnd + 1;
+        }
+        return success;
+    }
+ 
+#ifdef MINICONF_JSON_SUPPORT
+    MINICONF_INLINE bool Config::getJSONValue(const picojson::value *v, const std::string& flag, Source source){
+        uint32_t row = resolveOption(flag.c_str(), flag.size(), false);
+        // stray options keep the type of the json value
+        Value newValue = fromJSONValue(v, (row != OptionTable::NONE) ? _options->type(row) : Value::DataType::UNKNOWN);
+        if (newValue.isEmpty()){
+            log(LogLevel::WARNING, flag, "Unable to parse the option from config file, flag = ", flag);
+            return false;
+        }
+        layer(source)[flag] = std::move(newValue);
+        return true;
+    }
+
+    MINICONF_INLINE picojson::value Config::toJSONValue(const Value& v){
+        switch (v.type()) {
+            case Value::DataType::INT:
+                return picojson::value(static_cast<double>(v.getInt()));
+            case Value::DataType::NUMBER:
+                return picojson::value(v.getNumber());
+            case Value::DataType::BOOL:
+                return picojson::value(v.getBoolean());
+#ifdef PICOJSON_USE_INT64
+            case Value::DataType::INT64:
+                return picojson::value(v.getInt64());
+            case Value::DataType::UINT64:
+                if (v.getUInt64() <= static_cast<uint64_t>(INT64_MAX)) {
+                    return picojson::value(static_cast<int64_t>(v.getUInt64()));
+                }
+                return picojson::value(v.print());
+#else
+            case Value::DataType::INT64:
+            case Value::DataType::UINT64:
+#endif
+            // durations and byte sizes are written with units
+            case Value::DataType::DURATION:
+            case Value::DataType::BYTES:
+                return picojson::value(v.print());
+            default:
+                return picojson::value(v.getString());
+        }
+    }
+
+    MINICONF_INLINE Value Config::fromJSONValue(const picojson::value *v, Value::DataType type){
+        if (type == Value::DataType::UNKNOWN) {
+            return v->is<std::string>() ? Value(v->get<std::string>()) : 
+                v->is<bool>() ? Value(v->get<bool>()) : 
+                v->is<double>() ? Value(v->get<double>()) : Value::unknown();
+        }
+        if (v->is<std::string>()) {
+            // strings are parsed by other data types, e.g. "64MiB" or a large 64-bit integer
+            return (type == Value::DataType::STRING || type == Value::DataType::CHOICE) ? Value(v->get<std::string>()) : 
+                (type == Value::DataType::INT || type == Value::DataType::NUMBER || type == Value::DataType::BOOL) ? Value::unknown() : 
+                Value::parse(v->get<std::string>().c_str(), type);
+        }
+        if (v->is<bool>()) {
+            return (type == Value::DataType::BOOL) ? Value(v->get<bool>()) : Value::unknown();
+        }
+        if (!v->is<double>() || type == Value::DataType::STRING || type == Value::DataType::BOOL || type == Value::DataType::CHOICE) {
+            return Value::unknown();
+        }
+        if (type == Value::DataType::INT) {
+            // converting an out of range number to int is undefined
+            const double d = v->get<double>();
+            if (!(d >= static_cast<double>(INT_MIN) && d <= static_cast<double>(INT_MAX))) {
+                return Value::unknown();
+            }
+            return Value(static_cast<int>(d));
+        }
+        if (type == Value::DataType::NUMBER) {
+            return Value(v->get<double>());
+        }
+        // 64-bit integers, durations in nanoseconds and byte sizes in bytes
+        int64_t n = 0;
+        bool exact = false;
+#ifdef PICOJSON_USE_INT64
+        if (v->is<int64_t>()) {
+            n = v->get<int64_t>();
+            exact = true;
+        }
+#endif
+        if (!exact) {
+            // integral floating point numbers within the exactly representable range
+            const double d = v->get<double>();
+            if (d > 9007199254740992.0 || d < -9007199254740992.0 || d != static_cast<double>(static_cast<int64_t>(d))) {
+                return Value::unknown();
+            }
+            n = static_cast<int64_t>(d);
+        }
+        if (type == Value::DataType::INT64) {
+            return Value(n);
+        }
+        if (type == Value::DataType::DURATION) {
+            return Value::duration(n);
+        }
+        if (n < 0) {
+            return Value::unknown();
+        }
+        return (type == Value::DataType::UINT64) ? Value(static_cast<uint64_t>(n)) : Value::bytes(static_cast<uint64_t>(n));
+    }
+
+    MINICONF_INLINE bool Config::parseJSON(const picojson::value *v, const std::string& flag, Source source){
+        if (v->is<double>() || v->is<bool>() || v->is<std::string>()){
+            return getJSONValue(v, flag, source);
+        } else if (v->is<picojson::object>()){
+            bool success = true;
+            for (auto && objItem: v->get<picojson::object>()){
+                success = parseJSON(&(objItem.second), flag + (flag.empty() ? "" : ".") + objItem.first, source) && success;
+            }
+            return success;
+        } else if (v->is<picojson::array>()){
+            for (auto arrayItem : v->get<picojson::array>()){
+                // print array, not supported yet
+            }
+        } else {
+            log(LogLevel::WARNING, flag, "Unable to parse JSON, abort, flag = ", flag);
+            return false;
+        }
+        return false;
+    }
+
+    // parse context of a subtree
+    class Config::SubtreeParseContext
+    {
+        public:
+
+            // Constructs a context which parses into a value, the keys of the path from the depth are selected
+            SubtreeParseContext(picojson::value* out, const std::vector<std::string>& path, size_t depth);
+
+            // Values other than objects are not selected
+            bool set_null();
+            bool set_bool(bool);
+#ifdef PICOJSON_USE_INT64
+            bool set_int64(int64_t);
+#endif
+            bool set_number(double);
+            template <typename Iter> bool parse_string(picojson::input<Iter>& in);
+            bool parse_array_start();
+            template <typename Iter> bool parse_array_item(picojson::input<Iter>& in, size_t);
+            bool parse_array_stop(size_t);
+
+            // Objects only keep the selected key
+            bool parse_object_start();
+            template <typename Iter> bool parse_object_item(picojson::input<Iter>& in, const std::string& key);
+
+        private:
+
+            // The value which the subtree is parsed into
+            picojson::value* _out;
+
+            // Keys of the path from the root
+            const std::vector<std::string>* _path;
+
+            // Index of the key which the current object is matched against
+            size_t _depth;
+    };
+
+    MINICONF_INLINE Config::SubtreeParseContext::SubtreeParseContext(picojson::value* out, const std::vector<std::string>& path, size_t depth) 
+        : _out(out), _path(&path), _depth(depth)
+    {}
+
+    MINICONF_INLINE bool Config::SubtreeParseContext::set_null() 
+    {
+        return true;
+    }
+
+    MINICONF_INLINE bool Config::SubtreeParseContext::set_bool(bool) 
+    {
+        return true;
+    }
+
+#ifdef PICOJSON_USE_INT64
+    MINICONF_INLINE bool Config::SubtreeParseContext::set_int64(int64_t) 
+    {
+        return true;
     }
+#endif
 
-    Config::Option& Config::Option::defaultValue(const double& defaultValue)
+    MINICONF_INLINE bool Config::SubtreeParseContext::set_number(double) 
     {
-        _defaultValue = static_cast<double>(defaultValue);
-        return *this;
+        return true;
     }
 
-    Config::Option& Config::Option::defaultValue(const bool& defaultValue)
+    template <typename Iter> 
+    bool Config::SubtreeParseContext::parse_string(picojson::input<Iter>& in)
     {
-        _defaultValue = static_cast<bool>(defaultValue);
-        return *this;
+        // the opening quote has been consumed
+        in.ungetc();
+        return skipJSONValue(in);
     }
 
-    Config::Option& Config::Option::defaultValue(const char* defaultValue)
+    MINICONF_INLINE bool Config::SubtreeParseContext::parse_array_start() 
     {
-        _defaultValue = defaultValue;
-        return *this;
+        return true;
     }
 
-    Config::Option& Config::Option::defaultValue(const std::string& defaultValue)
+    template <typename Iter> 
+    bool Config::SubtreeParseContext::parse_array_item(picojson::input<Iter>& in, size_t)
     {
-        _defaultValue = static_cast<std::string>(defaultValue);
-        return *this;
+        return skipJSONValue(in);
     }
 
-    Config::Option& Config::Option::required(const bool required)
+    MINICONF_INLINE bool Config::SubtreeParseContext::parse_array_stop(size_t) 
     {
-        _required = required;
-        return *this;
+        return true;
     }
 
-    Config::Option& Config::Option::hidden(const bool hidden)
+    MINICONF_INLINE bool Config::SubtreeParseContext::parse_object_start()
     {
-        _hidden = hidden;
-        return *this;
+        *_out = picojson::value(picojson::object());
+        return true;
     }
 
-    std::string Config::Option::flag()
+    template <typename Iter> 
+    bool Config::SubtreeParseContext::parse_object_item(picojson::input<Iter>& in, const std::string& key)
     {
-        return _flag;
+        if (key != (*_path)[_depth]) {
+            return skipJSONValue(in);
+        }
+        picojson::value* item = &(_out->get<picojson::object>()[key]);
+        if (_depth + 1 == _path->size()) {
+            // the selected subtree is fully materialized
+            picojson::default_parse_context ctx(item);
+            return picojson::_parse(ctx, in);
+        }
+        SubtreeParseContext ctx(item, *_path, _depth + 1);
+        return picojson::_parse(ctx, in);
     }
 
-    std::string Config::Option::shortflag()
+    // parse context which records the positions of values
+    class Config::LazyParseContext
     {
-        return _shortflag;
-    }
+        public:
+
+            // Constructs a context which records the values of an object with a flag, the keys of the path from the depth are selected
+            LazyParseContext(Config* config, LazyValues* values, const std::vector<std::string>& path, size_t depth, std::string flag);
+
+            // Values other than objects are skipped
+            bool set_null();
+            bool set_bool(bool);
+#ifdef PICOJSON_USE_INT64
+            bool set_int64(int64_t);
+#endif
+            bool set_number(double);
+            template <typename Iter> bool parse_string(picojson::input<Iter>& in);
+            bool parse_array_start();
+            template <typename Iter> bool parse_array_item(picojson::input<Iter>& in, size_t);
+            bool parse_array_stop(size_t);
+
+            // The values of an object are recorded, nested objects are parsed recursively
+            bool parse_object_start();
+            template <typename Iter> bool parse_object_item(picojson::input<Iter>& in, const std::string& key);
+
+        private:
+
+            // The Config object which resolves the options
+            Config* _config;
+
+            // The values which are recorded
+            LazyValues* _values;
+
+            // Keys of the path from the root
+            const std::vector<std::string>* _path;
+
+            // Index of the key which the current object is matched against
+            size_t _depth;
 
-    std::string Config::Option::description()
+            // Flag of the current object
+            std::string _flag;
+    };
+
+    MINICONF_INLINE Config::LazyParseContext::LazyParseContext(Config* config, LazyValues* values, const std::vector<std::string>& path, size_t depth, std::string flag) 
+        : _config(config), _values(values), _path(&path), _depth(depth), _flag(std::move(flag))
+    {}
+
+    MINICONF_INLINE bool Config::LazyParseContext::set_null() 
     {
-        return _description;
+        return true;
     }
 
-    Value Config::Option::defaultValue()
+    MINICONF_INLINE bool Config::LazyParseContext::set_bool(bool) 
     {
-        return _defaultValue;
+        return true;
     }
 
-    bool Config::Option::required()
+#ifdef PICOJSON_USE_INT64
+    MINICONF_INLINE bool Config::LazyParseContext::set_int64(int64_t) 
     {
-        return _required;
+        return true;
     }
+#endif
 
-    bool Config::Option::hidden()
+    MINICONF_INLINE bool Config::LazyParseContext::set_number(double) 
     {
-        return _hidden;
+        return true;
     }
 
-    Value::DataType Config::Option::type()
+    template <typename Iter> 
+    bool Config::LazyParseContext::parse_string(picojson::input<Iter>& in)
     {
-        return _defaultValue.type();
+        // the opening quote has been consumed
+        in.ungetc();
+        return skipJSONValue(in);
     }
 
-    Config::Config() :
-        _verbose(false),
-        _logLevel(Config::LogLevel::WARNING),
-        _exeName(""),
-        _description(""),
-        _autoHelp(true),
-        _loadConfig(true)
+    MINICONF_INLINE bool Config::LazyParseContext::parse_array_start() 
     {
-        enableHelp(true); // set auto help to true
-        enableConfig(true); // set auto config to true
+        return true;
     }
 
-    Config::~Config()
+    template <typename Iter> 
+    bool Config::LazyParseContext::parse_array_item(picojson::input<Iter>& in, size_t)
     {
-        _options.clear();
-        _optionValues.clear();
-        _log.clear();
+        return skipJSONValue(in);
     }
 
-    Config::Option& Config::option(const std::string& flag)
+    MINICONF_INLINE bool Config::LazyParseContext::parse_array_stop(size_t) 
     {
-        _options.insert(std::make_pair(flag, Config::Option().flag(flag)));
-        return _options[flag];
+        return true;
     }
 
-    bool Config::remove(const std::string& flag)
+    MINICONF_INLINE bool Config::LazyParseContext::parse_object_start()
     {
-        if (findOption(flag)){
-            _options.erase(flag); 
-            return true; 
-        }
-        return false; 
+        return true;
     }
 
-    void Config::setDefaultValues()
+    template <typename Iter> 
+    bool Config::LazyParseContext::parse_object_item(picojson::input<Iter>& in, const std::string& key)
     {
-        for (auto && o : _options) {
-            _optionValues[o.first] = o.second.defaultValue();
+        if (_depth < _path->size() && key != (*_path)[_depth]) {
+            return skipJSONValue(in);
+        }
+        std::string flag = _flag.empty() ? key : _flag + "." + key;
+        in.skip_ws();
+        int ch = in.getc();
+        if (ch == -1) {
+            return false;
+        }
+        in.ungetc();
+        if (ch == '{') {
+            LazyParseContext ctx(_config, _values, *_path, _depth + 1, std::move(flag));
+            return picojson::_parse(ctx, in);
+        }
+        // the current character has been read once, so the position is behind it
+        const char* content = _values->content().data();
+        const size_t offset = static_cast<size_t>((in.cur() - 1) - content);
+        if (!skipJSONValue(in)) {
+            return false;
+        }
+        if (ch == '[') {
+            // arrays are not supported yet
+            return true;
+        }
+        // the value ends before the next character, or at the end of the content
+        ch = in.getc();
+        in.ungetc();
+        const size_t end = static_cast<size_t>(((ch == -1) ? in.cur() : in.cur() - 1) - content);
+        // values of hidden options are not recorded
+        uint32_t row = _config->resolveOption(flag.c_str(), flag.size(), false);
+        const OptionTable& options = *(_config->_options);
+        if (row == OptionTable::NONE || !options.hidden(row)) {
+            _values->add(std::move(flag), offset, end - offset, (row != OptionTable::NONE) ? options.type(row) : Value::DataType::UNKNOWN);
         }
+        return true;
     }
 
-    void Config::log(const LogLevel logType)
+    template <typename Iter>
+    bool Config::skipJSONValue(picojson::input<Iter>& in)
     {
-        _logLevel = logType;
+        in.skip_ws();
+        int depth = 0;
+        do {
+            int ch = in.getc();
+            if (ch == -1) {
+                return false;
+            } else if (ch == '"') {
+                // brackets in strings are not counted
+                for (ch = in.getc(); ch != '"'; ch = in.getc()) {
+                    if (ch == -1) {
+                        return false;
+                    } else if (ch == '\\') {
+                        in.getc();
+                    }
+                }
+            } else if (ch == '{' || ch == '[') {
+                ++depth;
+            } else if (ch == '}' || ch == ']') {
+                if (depth == 0) {
+                    return false;
+                }
+                --depth;
+            } else if (depth == 0) {
+                // a number or a literal ends before a delimiter
+                while (ch != -1 && ch != ',' && ch != '}' && ch != ']' && ch != ' ' && ch != '\t' && ch != '\n' && ch != '\r') {
+                    ch = in.getc();
+                }
+                in.ungetc();
+            }
+        } while (depth > 0);
+        return true;
     }
 
-    void Config::log(FILE* fd)
+    MINICONF_INLINE bool Config::loadJSON(const std::string& JSONStr, const std::vector<std::string>& path, Source source)
     {
-        fprintf(fd, "\n[[[  %s  ]]]\n\n", "PARSE LOG");
-        for (auto && logline : _log) {
-            fprintf(fd, "%s\n", logline.c_str());
+        picojson::value json;
+        std::string err;
+        if (path.empty()) {
+            picojson::parse(json, JSONStr.begin(), JSONStr.end(), &err);
+        } else {
+            SubtreeParseContext ctx(&json, path, 0);
+            picojson::_parse(ctx, JSONStr.begin(), JSONStr.end(), &err);
+        }
+        // a partially parsed file is not loaded
+        if (!err.empty()) {
+            log(LogLevel::ERROR, path.empty() ? "" : path.front().c_str(), "Unable to parse JSON, ", err);
+            return false;
         }
+        // values which cannot be converted are logged and skipped
+        parseJSON(&json, "", source);
+        return true;
     }
+#endif
 
-    void Config::log(Config::LogLevel logType, const std::string& token, const std::string& msg)
+    MINICONF_INLINE bool Config::loadLazy(std::string&& content, ExportFormat format, const std::vector<std::string>& path, Source source)
     {
-        // do don't anything if log level is low
-        if (logType < _logLevel) {
-            return;
+        auto values = std::make_shared<LazyValues>(std::move(content), format);
+        const std::string& str = values->content();
+        bool success = true;
+#ifdef MINICONF_JSON_SUPPORT
+        if (format == ExportFormat::JSON) {
+            LazyParseContext ctx(this, values.get(), path, 0, "");
+            std::string err;
+            picojson::_parse(ctx, str.data(), str.data() + str.size(), &err);
+            if (!err.empty()) {
+                log(LogLevel::ERROR, path.empty() ? "" : path.front().c_str(), "Unable to parse JSON, ", err);
+                success = false;
+            }
         }
-        const int tagWidth = 16;
-        char tag[tagWidth + 1];
-        char format[tagWidth + 1];
-        std::string logString = "";
-        snprintf(format, tagWidth, "<<<%%%ds>>>", tagWidth - 7);
-        switch (logType) {
-            case Config::LogLevel::INFO:
-                snprintf(tag, tagWidth, format, "INFO");
-                break;
-            case Config::LogLevel::WARNING:
-                snprintf(tag, tagWidth, format, "WARNING");
-                break;
-            case Config::LogLevel::ERROR:
-                snprintf(tag, tagWidth, format, "ERROR");
-                break;
-            default:
-                break;
+#endif
+        if (format == ExportFormat::CSV) {
+            // same as loadCSV(), flags are loaded if they are equal to the prefix, or start with the prefix and a dot
+            std::string prefix;
+            for (auto && key : path) {
+                prefix += (prefix.empty() ? "" : ".") + key;
+            }
+            const char* data = str.data();
+            for (size_t lineStart = 0; lineStart < str.size(); ) {
+                size_t lineEnd = std::find(data + lineStart, data + str.size(), '\n') - data;
+                // each line is a list of flags and values separated by commas
+                for (size_t flagStart = lineStart; flagStart < lineEnd; ) {
+                    size_t flagEnd = std::find(data + flagStart, data + lineEnd, ',') - data;
+                    size_t valueStart = std::min(flagEnd + 1, lineEnd);
+                    size_t valueEnd = std::find(data + valueStart, data + lineEnd, ',') - data;
+                    std::string sflag(data + flagStart, flagEnd - flagStart);
+                    flagStart = valueEnd + 1;
+                    if (valueStart == valueEnd) {
+                        continue;
+                    }
+                    if (!prefix.empty() && sflag.compare(0, prefix.size(), prefix) != 0) {
+                        continue;
+                    }
+                    if (!prefix.empty() && sflag.size() > prefix.size() && sflag[prefix.size()] != '.') {
+                        continue;
+                    }
+                    uint32_t row = resolveOption(sflag.c_str(), sflag.size(), false);
+                    if (row == OptionTable::NONE || !_options->hidden(row)) {
+                        values->add(std::move(sflag), valueStart, valueEnd - valueStart, (row != OptionTable::NONE) ? _options->type(row) : Value::DataType::UNKNOWN);
+                    }
+                }
+                lineStart = lineEnd + 1;
+            }
         }
-        logString = std::string(tag) + " Input \"" + token + "\" : " + msg;
-        _log.emplace_back(logString);
-        if (_verbose) {
-            fprintf(stdout, "%s\n", logString.c_str());
+        values->seal();
+        // a partially parsed file is not loaded
+        if (!success) {
+            return false;
+        }
+
+        // values loaded earlier into the same layer are shadowed
+        auto& loaded = layer(source);
+        for (size_t index = 0; !loaded.empty() && index < values->size(); ++index) {
+            loaded.erase(values->flag(index));
         }
+        lazyLayer(source).push_back(values);
+        log(LogLevel::INFO, "", values->size(), " values are recorded for lazy loading");
+        return success;
     }
 
-    Config::TokenType Config::getTokenType(const char* token)
+    MINICONF_INLINE bool Config::journal(const std::string& path, size_t compactSize)
     {
-        // get token type:
-        // starts with "--" - flag
-        // starts with "-" - shortflag/value
-        // otherwise value
-        size_t tlen = strlen(token);
-        if (tlen == 0) return TokenType::UNKNOWN;
-        if (token[0] == '-') {
-            // check if it can be converted to a number
-            char* endptr = nullptr;
-            std::strtod(token, &endptr);
-            if (*endptr == '\0' && endptr != token) {
-                return TokenType::VALUE;
-            }
-            return (token[1] == '-') ? TokenType::FLAG : TokenType::SHORTFLAG;
+        // the previous journal writes its pending records before it is closed
+        _journal.journal.reset();
+        auto journal = std::make_shared<Journal>(path, compactSize);
+        std::map<std::string, Value> values;
+        if (!journal->open(values)) {
+            log(LogLevel::ERROR, path, "unable to open the journal");
+            return false;
         }
-        return TokenType::VALUE;
+        log(LogLevel::INFO, path, values.size(), " values are replayed from the journal");
+        for (auto && v : values) {
+            layer(Source::USER)[v.first] = std::move(v.second);
+        }
+        resolveChoices(Source::USER);
+        _journal.journal = journal;
+        return true;
     }
 
-    std::string Config::translateShortflag(const std::string& shortflag)
+    MINICONF_INLINE void Config::set(const std::string& flag, const Value& value)
     {
-        auto found = _options.begin();
-        auto end = _options.end();
-        for (; found != end; ++found) {
-            if (found->second.shortflag() == shortflag) {
-                break;
+        // a choice may be set by its name, names which are not allowed are rejected
+        const Value* resolved = &value;
+        if (value.type() == Value::DataType::STRING && !_options->choices().empty()) {
+            const std::shared_ptr<const Choices>& choices = _options->choices(_options->find(flag.data(), flag.size()));
+            if (choices) {
+                int code = choices->find(value.getCharArray(), value.length());
+                if (code < 0) {
+                    if (logEnabled(LogLevel::ERROR)) {
+                        log(LogLevel::ERROR, flag, "invalid choice \"", value.getString(), "\", allowed values: ", choices->list());
+                    }
+                    return;
+                }
+                resolved = &(choices->value(code));
             }
         }
-        if (found != end) {
-            return found->first;
+        layer(Source::USER)[flag] = *resolved;
+        if (_journal.journal) {
+            _journal.journal->append(flag, *resolved);
         }
-        return shortflag;
     }
 
-    bool Config::findOption(const std::string& flag)
+    MINICONF_INLINE bool Config::sync()
     {
-        return (_options.find(flag) != _options.end());
+        return _journal.journal ? _journal.journal->sync() : true;
     }
 
-    Config::Option* Config::getOption(const char* token, Config::TokenType tokenType)
+    MINICONF_INLINE Config::Journal::Journal(const std::string& path, size_t compactSize) :
+        _path(path), _compactSize(compactSize), _file(nullptr), _size(0), _appended(0), _synced(0), _failed(false), _stop(false)
+    {}
+
+    MINICONF_INLINE Config::Journal::~Journal()
     {
-        std::string flag = "";
-        if (tokenType == TokenType::FLAG) {
-            flag = std::string(token + 2);
-        } else if (tokenType == TokenType::SHORTFLAG) {
-            flag = translateShortflag(std::string(token + 1));
-        }
-        if (flag.empty()) {
-            return nullptr;
+        if (_writer.joinable()) {
+            {
+                std::lock_guard<std::mutex> lock(_mutex);
+                _stop = true;
+            }
+            _appendedCond.notify_one();
+            _writer.join();
         }
-        if (findOption(flag)) {
-            return &(_options[flag]);
+        if (_file) {
+            fclose(_file);
         }
-        return nullptr;
     }
 
-    Value Config::parseValue(const char* token, Value::DataType dataType)
+    MINICONF_INLINE bool Config::Journal::open(std::map<std::string, Value>& values)
     {
-        if (dataType == Value::DataType::INT) {
-            int v;
-            int success = sscanf(token, "%d", &v);
-            return (success == 1) ? Value(v) : Value::unknown();
+        if (!replay(_path, values)) {
+            return false;
         }
-        if (dataType == Value::DataType::NUMBER) {
-            double v;
-            int success = sscanf(token, "%lf", &v);
-            return (success == 1) ? Value(v) : Value();
-
+        const std::string journalPath = _path + ".journal";
+        if (!replay(journalPath, values)) {
+            // the records after a partially written record are dropped with it
+            if (!writeSnapshot(values)) {
+                return false;
+            }
         }
-        if (dataType == Value::DataType::BOOL) {
-            std::string v(token);
-            if (v == "false" || v == "False" || v == "FALSE" || v == "F" || v == "f") {
-                return Value(false);
+        if (!_file) {
+            _file = fopen(journalPath.c_str(), "ab");
+            if (!_file) {
+                return false;
             }
-            return Value(true);
-
+            fseek(_file, 0, SEEK_END);
+            _size = static_cast<size_t>(ftell(_file));
         }
-        if (dataType == Value::DataType::STRING) {
-            return Value(token);
+        _writer = std::thread(&Journal::run, this);
+        return true;
+    }
+
+    MINICONF_INLINE void Config::Journal::append(const std::string& flag, const Value& value)
+    {
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            encode(_pending, flag, value);
+            ++_appended;
         }
-        return Value::unknown(); // fool-proof, return an unknown
+        _appendedCond.notify_one();
     }
 
-    static Config::LogLevel worseLevel(const Config::LogLevel& a, const Config::LogLevel& b)
+    MINICONF_INLINE bool Config::Journal::sync()
     {
-        return ((a) < (b)) ? (b) : (a);
+        std::unique_lock<std::mutex> lock(_mutex);
+        const uint64_t appended = _appended;
+        _syncedCond.wait(lock, [&]() {
+            return _synced >= appended;
+        });
+        return !_failed;
     }
 
-    Config::LogLevel Config::checkFormat()
+    MINICONF_INLINE void Config::Journal::run()
     {
-        LogLevel errorLv = LogLevel::INFO;
-        for (auto && opt : _options) {
-            Option& o = opt.second;
-            // check for error
-            if (!o.required() && o.defaultValue().isEmpty()) {
-                log(LogLevel::ERROR, o.flag(), "default value is not defined");
-                errorLv = worseLevel(errorLv, LogLevel::ERROR);
-            }
-            for (auto& opt2 : _options) {
-                Option& o2 = opt2.second;
-                if ((o.flag() != o2.flag()) && (o.shortflag() == o2.shortflag()) && !(o.shortflag().empty())) {
-                    log(LogLevel::ERROR, o.flag(), "duplicate short flags (" + o2.shortflag() + ")");
-                    errorLv = worseLevel(errorLv, LogLevel::ERROR);
-                }
+        std::unique_lock<std::mutex> lock(_mutex);
+        while (true) {
+            _appendedCond.wait(lock, [&]() {
+                return _stop || !_pending.empty();
+            });
+            if (_pending.empty()) {
+                break;
             }
-            // check for warnings
-            if (o.description().empty()) {
-                log(LogLevel::WARNING, o.flag(), "no description text for argument");
-                errorLv = worseLevel(errorLv, LogLevel::WARNING);
+            // records appended while the batch is synced are written in the next batch
+            std::string batch;
+            batch.swap(_pending);
+            const uint64_t appended = _appended;
+            lock.unlock();
+            // the journal is reopened if a compaction failed to reopen it
+            if (!_file) {
+                _file = fopen((_path + ".journal").c_str(), "ab");
             }
-            if (o.shortflag().empty()) {
-                log(LogLevel::WARNING, o.flag(), "no short flag is provided");
-                errorLv = worseLevel(errorLv, LogLevel::WARNING);
+            bool success = _file && fwrite(batch.data(), 1, batch.size(), _file) == batch.size() && syncFile(_file);
+            _size += batch.size();
+            lock.lock();
+            _failed = _failed || !success;
+            _synced = appended;
+            _syncedCond.notify_all();
+            if (success && _size >= _compactSize) {
+                // the batch is synced before the compaction, so sync() does not wait for the snapshot to be rewritten
+                lock.unlock();
+                success = compact();
+                lock.lock();
+                _failed = _failed || !success;
             }
         }
-        if (_description.empty()) {
-            log(LogLevel::WARNING, "", "No program description text is provided");
-            errorLv = worseLevel(errorLv, LogLevel::WARNING);
-        }
-        return errorLv;
     }
 
-    // Validate User Input
-    Config::LogLevel Config::validate()
+    MINICONF_INLINE bool Config::Journal::compact()
     {
-        LogLevel errorLv = LogLevel::INFO;
-
-        // remove all the hidden values
-        for (auto&& opt: _options){
-            if (opt.second.hidden() && contains(opt.first)){
-                _optionValues.erase(opt.first);
-            }
+        std::map<std::string, Value> values;
+        if (!replay(_path, values)) {
+            return false;
         }
+        replay(_path + ".journal", values);
+        return writeSnapshot(values);
+    }
 
-        // scan for all option vlaues 
-        for (auto && val : _optionValues) {
-            if (val.second.isEmpty()) {
-                log(LogLevel::ERROR, val.first, "option contains invalid value");
-                errorLv = worseLevel(errorLv, LogLevel::ERROR);
-            }
+    MINICONF_INLINE bool Config::Journal::writeSnapshot(const std::map<std::string, Value>& values)
+    {
+        std::string content;
+        for (auto && v : values) {
+            encode(content, v.first, v.second);
+        }
+        const std::string tempPath = _path + ".tmp";
+        FILE* fd = fopen(tempPath.c_str(), "wb");
+        bool success = fd && fwrite(content.data(), 1, content.size(), fd) == content.size() && syncFile(fd);
+        if (fd) {
+            fclose(fd);
+        }
+#ifdef _WIN32
+        // rename() does not replace an existing file
+        success = success && (std::remove(_path.c_str()) == 0 || errno == ENOENT);
+#endif
+        if (!success || std::rename(tempPath.c_str(), _path.c_str()) != 0) {
+            std::remove(tempPath.c_str());
+            return false;
         }
+        // the rename must be durable before the journal is emptied, or a crash could lose both
+        if (!syncDirectory(_path)) {
+            return false;
+        }
+        // the journal is emptied after the snapshot replaces the previous one
+        if (_file) {
+            fclose(_file);
+        }
+        const std::string journalPath = _path + ".journal";
+        fd = fopen(journalPath.c_str(), "wb");
+        success = fd && syncFile(fd);
+        if (fd) {
+            fclose(fd);
+        }
+        _file = fopen(journalPath.c_str(), "ab");
+        _size = 0;
+        return success && _file;
+    }
 
-        // scan for all remaining options are defined
-        for (auto && opt : _options) {
-            if (!contains(opt.first) && !opt.second.hidden()) {
-                log(LogLevel::ERROR, opt.first, "option is undefined");
-                errorLv = worseLevel(errorLv, LogLevel::ERROR);
+    MINICONF_INLINE void Config::Journal::encode(std::string& out, const std::string& flag, const Value& value)
+    {
+        char data[sizeof(uint64_t)];
+        const char* valueData = data;
+        uint32_t valueLength = sizeof(uint64_t);
+        switch (value.type()) {
+            case Value::DataType::INT:
+            case Value::DataType::INT64: {
+                int64_t n = value.getInt64();
+                memcpy(data, &n, sizeof(n));
+                break;
+            }
+            case Value::DataType::NUMBER: {
+                double n = value.getNumber();
+                memcpy(data, &n, sizeof(n));
+                break;
+            }
+            case Value::DataType::DURATION: {
+                int64_t n = value.getDuration();
+                memcpy(data, &n, sizeof(n));
+                break;
+            }
+            case Value::DataType::UINT64: {
+                uint64_t n = value.getUInt64();
+                memcpy(data, &n, sizeof(n));
+                break;
+            }
+            case Value::DataType::BYTES: {
+                uint64_t n = value.getBytes();
+                memcpy(data, &n, sizeof(n));
+                break;
             }
+            case Value::DataType::BOOL:
+                data[0] = value.getBoolean() ? 1 : 0;
+                valueLength = 1;
+                break;
+            case Value::DataType::STRING:
+            case Value::DataType::CHOICE:
+                valueData = value.getCharArray();
+                valueLength = static_cast<uint32_t>(value.length());
+                break;
+            default:
+                valueLength = 0;
+                break;
         }
-        return errorLv;
+        // the checksum covers the record after it
+        const size_t start = out.size();
+        const uint32_t flagLength = static_cast<uint32_t>(flag.size());
+        const char type = static_cast<char>(value.type());
+        out.append(sizeof(uint32_t), '\0');
+        out.append(reinterpret_cast<const char*>(&flagLength), sizeof(flagLength));
+        out.append(reinterpret_cast<const char*>(&valueLength), sizeof(valueLength));
+        out.append(1, type);
+        out.append(flag);
+        out.append(valueData, valueLength);
+        const uint32_t checksum = FlagTable::hash(out.data() + start + sizeof(uint32_t), out.size() - start - sizeof(uint32_t), 0);
+        memcpy(&out[start], &checksum, sizeof(checksum));
     }
 
-    bool Config::parse(int argc, char **argv)
+    MINICONF_INLINE bool Config::Journal::decode(const char*& p, const char* end, std::string& flag, Value& value)
     {
-        // Extract executable name
-        _exeName = std::string(argv[0]);
-        size_t lastslash = _exeName.find_last_of("\\/");
-        if (lastslash != std::string::npos) {
-            _exeName = _exeName.substr(lastslash + 1);
+        if (static_cast<size_t>(end - p) < HEADER_SIZE) {
+            return false;
         }
-
-        // check format of the option parser
-        // if fatal error occurs and log level is not "NONE" (NONE = ignore errors)
-        LogLevel checkFormatResult = checkFormat();
-        if (checkFormatResult >= LogLevel::ERROR && _logLevel <= LogLevel::ERROR) {
-            log();
-            printf("\nFatal Error: Option format validation failed, abort.\n\n");
+        uint32_t checksum = 0;
+        uint32_t flagLength = 0;
+        uint32_t valueLength = 0;
+        memcpy(&checksum, p, sizeof(checksum));
+        memcpy(&flagLength, p + 4, sizeof(flagLength));
+        memcpy(&valueLength, p + 8, sizeof(valueLength));
+        const Value::DataType type = static_cast<Value::DataType>(p[12]);
+        const size_t size = HEADER_SIZE + static_cast<size_t>(flagLength) + valueLength;
+        if (static_cast<size_t>(end - p) < size || FlagTable::hash(p + 4, size - 4, 0) != checksum) {
             return false;
         }
-
-        // define a wildcard option to capture "stray" option values (values without a flag)
-        // string argument by default
-        Config::Option wildcard;
-        wildcard.defaultValue("");
-
-        // Value Precedence:
-        // (1) Default Value
-        // (2) Config File Settings (overwrites default values)
-        // (3) Command Line Arguments (overwrites default values and config file)
-
-        // * Set Default Values
-        setDefaultValues();
-
-        // * Load Config File before scanning for other arguments
-        // case 1: only config file is defined, flag is not necessary
-        // case 2: check if config flag has been defined
-        if (_loadConfig) {
-            for (int i = 1; i < argc - 1; ++i) {
-                std::string flag = std::string(argv[i]);
-                std::string value = std::string(argv[i + 1]);
-                TokenType ttype = getTokenType(argv[i + 1]);
-                if (( flag == "--config" || flag == "-cfg" ) && (ttype == TokenType::VALUE)) {
-                    config(value);
-                }
-            }
+        const char* data = p + HEADER_SIZE + flagLength;
+        flag.assign(p + HEADER_SIZE, flagLength);
+        int64_t n = 0;
+        uint64_t u = 0;
+        double d = 0;
+        if (valueLength == sizeof(uint64_t)) {
+            memcpy(&n, data, sizeof(n));
+            memcpy(&u, data, sizeof(u));
+            memcpy(&d, data, sizeof(d));
         }
-
-        // start normal parsing
-        Option* currentOption = nullptr;
-        for (int i = 1; i < argc; ++i) {
-            TokenType currentTokenType = getTokenType(argv[i]);
-            if (currentTokenType == TokenType::UNKNOWN) {
-                log(LogLevel::ERROR, std::string(argv[i]), "unknown input");
-            } else if (currentTokenType == TokenType::FLAG || currentTokenType == TokenType::SHORTFLAG) {
-                currentOption = getOption(argv[i], currentTokenType);
-                if (!currentOption) {
-                    log(LogLevel::WARNING, std::string(argv[i]), "unrecognized flag");
-                    if (currentTokenType == TokenType::FLAG) {
-                        wildcard.flag(std::string(argv[i] + 2));
-                        currentOption = &wildcard;
-                    }
-                }
-                // special case - if the option type is bool, set to true by default
-                if (currentOption && currentOption->type() == Value::DataType::BOOL) {
-                    _optionValues[currentOption->flag()] = true;
-                }
-            } else if (currentTokenType == TokenType::VALUE) {
-                if (currentOption) {
-                    // parse the value according to default data type
-                    Value newValue = parseValue(argv[i], currentOption->type());
-                    // if value cannot be parsed
-                    if (newValue.isEmpty()) {
-                        log(LogLevel::WARNING, std::string(argv[i]), "unvalid value type is provided");
-                    } else {
-                        // assign parsed values
-                        _optionValues[currentOption->flag()] = parseValue(argv[i], currentOption->type());
-                        log(LogLevel::INFO, std::string(argv[i]), "value parsed successfully");
-                    }
-                    // reset current option flag -> ready for a new flag
-                    currentOption = nullptr;
-                } else {
-                    // stray arguments, ignore
-                    log(LogLevel::WARNING, std::string(argv[i]), "unassociated argument is not stored");
-                }
-            }
+        switch (type) {
+            case Value::DataType::INT:
+                value = static_cast<int>(n);
+                break;
+            case Value::DataType::INT64:
+                value = n;
+                break;
+            case Value::DataType::NUMBER:
+                value = d;
+                break;
+            case Value::DataType::DURATION:
+                value = Value::duration(n);
+                break;
+            case Value::DataType::UINT64:
+                value = u;
+                break;
+            case Value::DataType::BYTES:
+                value = Value::bytes(u);
+                break;
+            case Value::DataType::BOOL:
+                value = (valueLength == 1 && data[0] != 0);
+                break;
+            case Value::DataType::STRING:
+            case Value::DataType::CHOICE:
+                // a choice is replayed by name, the Config object resolves it to its current code
+                value = std::string(data, valueLength);
+                break;
+            default:
+                value = Value::unknown();
+                break;
         }
+        p += size;
+        return true;
+    }
 
-        // if contains help and auto-help is enabled, display help message
-        if (contains("help") && _optionValues["help"].getBoolean() && _autoHelp) {
-            help();
+    MINICONF_INLINE bool Config::Journal::replay(const std::string& path, std::map<std::string, Value>& values)
+    {
+        std::string content;
+        if (!readFile(path, content)) {
+            return true;
         }
+        const char* p = content.data();
+        const char* end = p + content.size();
+        std::string flag;
+        Value value;
+        while (p < end && decode(p, end, flag, value)) {
+            values[flag] = std::move(value);
+        }
+        return p == end;
+    }
 
-        // validate user inputs
-        // remove all hidden options
-        // reserved words should not be displayed as normal config values
-
-        // if fatal error occurs and log level is not "NONE" (NONE = ignore errors)
-        LogLevel validateResult = validate();
-        if (validateResult >= LogLevel::ERROR && _logLevel <= LogLevel::ERROR) {
-            log();
-            printf("\nFatal Error: Option format validation failed, abort.\n\n");
+    MINICONF_INLINE bool Config::Journal::syncFile(FILE* fd)
+    {
+        if (fflush(fd) != 0) {
             return false;
         }
+#ifdef _WIN32
+        return _commit(_fileno(fd)) == 0;
+#else
+        return fsync(fileno(fd)) == 0;
+#endif
+    }
 
+    MINICONF_INLINE bool Config::Journal::syncDirectory(const std::string& path)
+    {
+#ifdef _WIN32
+        // directories cannot be synced, a rename is durable when it returns
+        (void)path;
         return true;
+#else
+        size_t slash = path.rfind('/');
+        const std::string directory = (slash == std::string::npos) ? "." : (slash == 0 ? "/" : path.substr(0, slash));
+        int fd = ::open(directory.c_str(), O_RDONLY);
+        if (fd < 0) {
+            return false;
+        }
+        bool success = fsync(fd) == 0;
+        ::close(fd);
+        return success;
+#endif
     }
 
-    void Config::help(FILE* fd)
+#ifdef MINICONF_SHARED_MEMORY
+    MINICONF_INLINE bool Config::publish(const std::string& name, unsigned int mode)
     {
-        // print program description
-        if (!_description.empty()) {
-            fprintf(fd, "\n");
-            if (!_exeName.empty()) {
-                fprintf(fd, "[[[  %s  ]]]\n\n    ", _exeName.c_str());
+        typedef SharedSegment::Control Control;
+        typedef SharedSegment::Header Header;
+        typedef SharedSegment::Entry Entry;
+
+        std::map<std::string, const Value*> all;
+        values(all);
+        // header and entries, followed by null-terminated flags and strings
+        size_t size = sizeof(Header) + all.size() * sizeof(Entry);
+        for (auto && v : all) {
+            size += v.first.size() + 1;
+            if (v.second->type() == Value::DataType::STRING) {
+                size += v.second->length() + 1;
+            } else if (v.second->type() == Value::DataType::CHOICE) {
+                size += v.second->length() + 1 + sizeof(int32_t);
             }
-            fprintf(fd, "%s\n\n", _description.c_str());
         }
 
-        // print usage
-        usage();
-        // print help
-        fprintf(fd, "\n[[[  %s  ]]]\n\n", "HELP");
-        for (auto && opt : _options) {
-            Option& o = opt.second;
-            // print short
-            fprintf(fd, "    ");
-            if (!o.shortflag().empty()) {
-                fprintf(fd, "-%s, ", o.shortflag().c_str());
-            }
-            // print long
-            fprintf(fd, "--%s ", o.flag().c_str());
-            // required
-            if (o.required()) {
-                fprintf(fd, "<REQUIRED>");
-            }
-            fprintf(fd, "\n");
-            // print description
-            fprintf(fd, "        ");
-            if (!o.description().empty()) {
-                fprintf(fd, "%s ", o.description().c_str());
+        // the control segment is created on the first publish
+        int fd = shm_open(name.c_str(), O_CREAT | O_RDWR, static_cast<mode_t>(mode));
+        if (fd < 0) {
+            log(LogLevel::ERROR, name, "unable to open shared memory, ", strerror(errno));
+            return false;
+        }
+        struct stat st;
+        void* controlAddr = MAP_FAILED;
+        if (fstat(fd, &st) == 0 && (static_cast<size_t>(st.st_size) >= sizeof(Control) || ftruncate(fd, sizeof(Control)) == 0)) {
+            controlAddr = mmap(nullptr, sizeof(Control), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        }
+        close(fd);
+        if (controlAddr == MAP_FAILED) {
+            log(LogLevel::ERROR, name, "unable to map shared memory, ", strerror(errno));
+            return false;
+        }
+        Control* control = static_cast<Control*>(controlAddr);
+        if (memcmp(control->magic, "MINICONF", sizeof(control->magic)) != 0) {
+            new (&(control->generation)) std::atomic<uint64_t>(0);
+            memcpy(control->magic, "MINICONF", sizeof(control->magic));
+        }
+
+        // a segment left by a failed publish is replaced
+        const uint64_t generation = control->generation.load(std::memory_order_relaxed) + 1;
+        const std::string segmentName = name + "." + std::to_string(generation);
+        shm_unlink(segmentName.c_str());
+        fd = shm_open(segmentName.c_str(), O_CREAT | O_EXCL | O_RDWR, static_cast<mode_t>(mode));
+        void* addr = MAP_FAILED;
+        if (fd >= 0) {
+            if (ftruncate(fd, static_cast<off_t>(size)) == 0) {
+                addr = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
             }
-            // default value
-            if (!o.defaultValue().isEmpty() && !o.hidden()) {
-                fprintf(fd, " ( ");
-                fprintf(fd, "DEFAULT = %s", o.defaultValue().print().c_str());
-                fprintf(fd, " ) ");
+            close(fd);
+        }
+        if (addr == MAP_FAILED) {
+            log(LogLevel::ERROR, segmentName, "unable to create shared memory, ", strerror(errno));
+            shm_unlink(segmentName.c_str());
+            munmap(controlAddr, sizeof(Control));
+            return false;
+        }
+
+        char* data = static_cast<char*>(addr);
+        Header* header = reinterpret_cast<Header*>(data);
+        memcpy(header->magic, "MINICONF", sizeof(header->magic));
+        header->generation = generation;
+        header->size = size;
+        header->count = all.size();
+        Entry* entry = reinterpret_cast<Entry*>(data + sizeof(Header));
+        size_t offset = sizeof(Header) + all.size() * sizeof(Entry);
+        for (auto && v : all) {
+            const Value& value = *(v.second);
+            entry->flag = offset;
+            entry->flagLength = static_cast<uint32_t>(v.first.size());
+            memcpy(data + offset, v.first.c_str(), v.first.size() + 1);
+            offset += v.first.size() + 1;
+            entry->type = static_cast<uint32_t>(value.type());
+            entry->data = 0;
+            entry->length = 0;
+            switch (value.type()) {
+                case Value::DataType::INT:
+                case Value::DataType::INT64:
+                    entry->data = static_cast<uint64_t>(value.getInt64());
+                    break;
+                case Value::DataType::NUMBER: {
+                    double number = value.getNumber();
+                    memcpy(&(entry->data), &number, sizeof(number));
+                    break;
+                }
+                case Value::DataType::BOOL:
+                    entry->data = value.getBoolean() ? 1 : 0;
+                    break;
+                case Value::DataType::UINT64:
+                    entry->data = value.getUInt64();
+                    break;
+                case Value::DataType::DURATION:
+                    entry->data = static_cast<uint64_t>(value.getDuration());
+                    break;
+                case Value::DataType::BYTES:
+                    entry->data = value.getBytes();
+                    break;
+                case Value::DataType::STRING:
+                    entry->data = offset;
+                    entry->length = value.length();
+                    memcpy(data + offset, value.getCharArray(), value.length() + 1);
+                    offset += value.length() + 1;
+                    break;
+                case Value::DataType::CHOICE: {
+                    // the name is followed by the code
+                    int32_t code = static_cast<int32_t>(value.getChoice());
+                    entry->data = offset;
+                    entry->length = value.length();
+                    memcpy(data + offset, value.getCharArray(), value.length() + 1);
+                    memcpy(data + offset + value.length() + 1, &code, sizeof(code));
+                    offset += value.length() + 1 + sizeof(code);
+                    break;
+                }
+                default:
+                    break;
             }
-            fprintf(fd, "\n\n");
+            ++entry;
+        }
+        munmap(addr, size);
+
+        // readers switch to the new generation, the previous segment stays valid until it is unmapped
+        control->generation.store(generation, std::memory_order_release);
+        munmap(controlAddr, sizeof(Control));
+        if (generation > 1) {
+            shm_unlink((name + "." + std::to_string(generation - 1)).c_str());
         }
+        log(LogLevel::INFO, name, "config is published, generation = ", generation);
+        return true;
     }
 
-    void Config::usage(FILE* fd)
+    MINICONF_INLINE bool Config::unpublish(const std::string& name)
     {
-        fprintf(fd, "\n[[[  %s  ]]]\n\n", "USAGE");
-        char exeTag[256];
-        snprintf(exeTag, 256 - 1, "    %s ", (_exeName.empty()) ? ("<executable>") : (_exeName.c_str()));
-        fprintf(fd, "%s", exeTag);
-        int lineWidth = 0;
-        for (auto && opt : _options) {
-            Option& o = opt.second;
-            char argTag[512];
-            snprintf(argTag, 512 - 1, "%s%s%s <%s>%s",
-                    o.required() ? "" : "[",
-                    o.shortflag().empty() ? "--" : "-",
-                    o.shortflag().empty() ? o.flag().c_str() : o.shortflag().c_str(),
-                    o.defaultValue().printType().c_str(),
-                    o.required() ? "" : "]");
-            if (lineWidth + strlen(argTag) >= 80 - 1 - strlen(exeTag)) {
-                fprintf(fd, "\n%*s", static_cast<int>(strlen(exeTag)), " ");
-                lineWidth = 0;
+        size_t size = 0;
+        const char* control = SharedSegment::map(name, size);
+        if (control) {
+            if (size >= sizeof(SharedSegment::Control)) {
+                uint64_t generation = reinterpret_cast<const SharedSegment::Control*>(control)->generation.load();
+                shm_unlink((name + "." + std::to_string(generation)).c_str());
             }
-            fprintf(fd, "%s ", argTag);
-            lineWidth += strlen(argTag);
+            munmap(const_cast<char*>(control), size);
         }
-        fprintf(fd, "\n\n");
+        return shm_unlink(name.c_str()) == 0;
     }
 
-    void Config::description(const std::string& desc)
+    MINICONF_INLINE Config::SharedSegment::SharedSegment() : _control(nullptr), _data(nullptr), _size(0)
+    {}
+
+    MINICONF_INLINE Config::SharedSegment::~SharedSegment()
     {
-        _description = desc;
+        detach();
     }
 
-    void Config::enableConfig(bool enabled)
+    MINICONF_INLINE bool Config::SharedSegment::attach(const std::string& name)
     {
-        _loadConfig = enabled;
-        if (_autoHelp && !findOption("config")) {
-            option("config").
-                shortflag("cfg").
-                defaultValue("").
-                description("Input configuration file (JSON/CSV)").
-                required(false).hidden(true);
-        } else {
-            if (findOption("config")) {
-                _options.erase("config");
-            }
+        detach();
+        size_t size = 0;
+        const char* control = map(name, size);
+        if (!control) {
+            return false;
         }
-
+        if (size < sizeof(Control) || memcmp(control, "MINICONF", sizeof(Control::magic)) != 0) {
+            munmap(const_cast<char*>(control), size);
+            return false;
+        }
+        _name = name;
+        _control = reinterpret_cast<const Control*>(control);
+        if (!refresh()) {
+            detach();
+            return false;
+        }
+        return true;
     }
 
-    void Config::enableHelp(bool enabled)
+    MINICONF_INLINE bool Config::SharedSegment::refresh()
     {
-        _autoHelp = enabled;
-        if (_autoHelp && !findOption("help")) {
-            option("help").
-                shortflag("h").
-                defaultValue(false).
-                description("Display the help message").
-                required(false).hidden(true);
-        } else {
-            if (findOption("help")) {
-                _options.erase("help");
+        if (!_control) {
+            return false;
+        }
+        // a generation may be unlinked by a newer publish before it is mapped
+        for (int attempt = 0; attempt < 3; ++attempt) {
+            const uint64_t latest = _control->generation.load(std::memory_order_acquire);
+            if (latest == 0 || latest == generation()) {
+                return false;
+            }
+            size_t size = 0;
+            const char* data = map(_name + "." + std::to_string(latest), size);
+            if (!data) {
+                continue;
+            }
+            const Header* header = reinterpret_cast<const Header*>(data);
+            if (size < sizeof(Header) || memcmp(header->magic, "MINICONF", sizeof(header->magic)) != 0 || 
+                header->size != size || header->count > (size - sizeof(Header)) / sizeof(Entry)) {
+                munmap(const_cast<char*>(data), size);
+                return false;
+            }
+            if (_data) {
+                munmap(const_cast<char*>(_data), _size);
             }
+            _data = data;
+            _size = size;
+            return true;
         }
+        return false;
     }
 
-    void Config::verbose(bool value)
+    MINICONF_INLINE void Config::SharedSegment::detach()
     {
-        _verbose = value;
+        if (_data) {
+            munmap(const_cast<char*>(_data), _size);
+        }
+        if (_control) {
+            munmap(const_cast<Control*>(_control), sizeof(Control));
+        }
+        _control = nullptr;
+        _data = nullptr;
+        _size = 0;
     }
 
-    bool Config::contains(const std::string& flag)
+    MINICONF_INLINE uint64_t Config::SharedSegment::generation() const
     {
-        return _optionValues.find(flag) != _optionValues.end();
+        return _data ? reinterpret_cast<const Header*>(_data)->generation : 0;
     }
 
-    Value& Config::operator[](const std::string& flag)
+    MINICONF_INLINE size_t Config::SharedSegment::size() const
     {
-        return _optionValues[flag];
+        return _data ? static_cast<size_t>(reinterpret_cast<const Header*>(_data)->count) : 0;
     }
 
-    void Config::print(FILE* fd)
+    MINICONF_INLINE bool Config::SharedSegment::contains(const std::string& flag) const
     {
-        fprintf(fd, "\n[[[  %s  ]]]\n\n", "CONFIGURATION");
-
-        printf("|-------------------------|------------|--------------------------------------------------|\n");
-        printf("|           NAME          |    TYPE    |                     VALUE                        |\n");
-        printf("|-------------------------|------------|--------------------------------------------------|\n");
-        for (auto && v : _optionValues) {
-            if (_options.find(v.first.c_str()) != _options.end()) {
-                fprintf(fd, "| %-23s | %-10s | %-48s |\n", v.first.c_str(), v.second.printType().c_str(), v.second.print().c_str());
-            } else {
-                fprintf(fd, "| %-23s | %-10s | %-48s |\n", v.first.c_str(), (v.second.printType() + "*").c_str(), v.second.print().c_str());
-            }
-        }
-        printf("|-------------------------|------------|--------------------------------------------------|\n");
-        printf("\n");
+        return find(flag) != nullptr;
     }
 
-    std::string Config::serialize(const std::string& serializeFilePath, ExportFormat format, bool pretty)
+    MINICONF_INLINE Value Config::SharedSegment::value(const std::string& flag) const
     {
-        std::stringstream ss;
-        std::string outStr;
-
-        // extract extension
-        std::string extension = "";
-        size_t lastDot = serializeFilePath.find_last_of(".");
-        if (lastDot != std::string::npos) {
-            extension = serializeFilePath.substr(lastDot + 1);
-        }
-#ifdef MINICONF_JSON_SUPPORT
-        if (extension == "json" || extension == "JSON"){
-            format = ExportFormat::JSON; 
-        } else if (extension == "csv" || extension == "CSV"){
-            format = ExportFormat::CSV; 
-        } else {
-            format = ExportFormat::CSV; 
+        const Entry* entry = find(flag);
+        if (!entry) {
+            return Value();
         }
-#else
-        format = ExportFormat::CSV; 
-#endif
-
-        // serialize JSON
-#ifdef MINICONF_JSON_SUPPORT
-        if (format == ExportFormat::JSON) {
-            picojson::value outObj = picojson::value(picojson::object());
-            for (auto v: _optionValues){
-                std::vector<std::string> flagTokens;
-                std::stringstream ss(v.first);
-                // tokenize
-                while (ss.good()){
-                    std::string tempToken;
-                    std::getline(ss, tempToken, '.');
-                    flagTokens.emplace_back(tempToken);
-                }
-                // parse
-                if (flagTokens.size() > 1){
-                    picojson::value* thisObj = &outObj;
-                    for (size_t i = 0; i < flagTokens.size(); ++i){
-                        if (i != flagTokens.size() - 1){
-                            if (thisObj->get<picojson::object>().find(flagTokens[i]) == thisObj->get<picojson::object>().end()){
-                                thisObj->get<picojson::object>()[flagTokens[i]] = picojson::value(picojson::object());
-                            }
-                            thisObj = &(thisObj->get<picojson::object>()[flagTokens[i]]);
-                        } else {
-                            if (v.second.type() == Value::DataType::INT){
-                                thisObj->get<picojson::object>()[flagTokens[i]] = picojson::value(static_cast<double>(v.second.getInt()));
-                            } else if (v.second.type() == Value::DataType::NUMBER){
-                                thisObj->get<picojson::object>()[flagTokens[i]] = picojson::value(v.second.getNumber());
-                            } else if (v.second.type() == Value::DataType::BOOL){
-                                thisObj->get<picojson::object>()[flagTokens[i]] = picojson::value(v.second.getBoolean());
-                            } else if (v.second.type() == Value::DataType::STRING){
-                                thisObj->get<picojson::object>()[flagTokens[i]] = picojson::value(v.second.getString());
-                            } 
-                        
-                        }
-                    }
-                }else{
-                    if (outObj.get<picojson::object>().find(flagTokens[0]) == outObj.get<picojson::object>().end()){
-                        if (v.second.type() == Value::DataType::INT){
-                            outObj.get<picojson::object>()[flagTokens[0]] = picojson::value(static_cast<double>(v.second.getInt()));
-                        } else if (v.second.type() == Value::DataType::NUMBER){
-                            outObj.get<picojson::object>()[flagTokens[0]] = picojson::value(v.second.getNumber());
-                        } else if (v.second.type() == Value::DataType::BOOL){
-                            outObj.get<picojson::object>()[flagTokens[0]] = picojson::value(v.second.getBoolean());
-                        }  else if (v.second.type() == Value::DataType::STRING){
-                            outObj.get<picojson::object>()[flagTokens[0]] = picojson::value(v.second.getString());
-                        } 
-                    }
-                }
+        switch (static_cast<Value::DataType>(entry->type)) {
+            case Value::DataType::INT:
+                return Value(static_cast<int>(static_cast<int64_t>(entry->data)));
+            case Value::DataType::NUMBER: {
+                double number = 0;
+                memcpy(&number, &(entry->data), sizeof(number));
+                return Value(number);
             }
-            outStr = outObj.serialize(true);
-        }
-#endif
-
-        // serialize CSV
-        if (format == ExportFormat::CSV) {
-            for (auto opt = std::begin(_optionValues); opt != std::end(_optionValues); ++opt) {
-                std::string flag = opt->first;
-                std::string val = opt->second.print();
-                if (opt->second.type() == Value::DataType::STRING){
-                    // remove "" from string
-                    if (val.size() >= 2){ 
-                        val = val.substr(1, val.size()-2);
-                    }
-                }
-                ss << flag << "," << val << std::endl; 
+            case Value::DataType::BOOL:
+                return Value(entry->data != 0);
+            case Value::DataType::STRING:
+                return Value(_data + entry->data);
+            case Value::DataType::CHOICE: {
+                int32_t code = 0;
+                memcpy(&code, _data + entry->data + entry->length + 1, sizeof(code));
+                return Value::choice(code, _data + entry->data);
             }
-            outStr = ss.str();
+            case Value::DataType::INT64:
+                return Value(static_cast<int64_t>(entry->data));
+            case Value::DataType::UINT64:
+                return Value(entry->data);
+            case Value::DataType::DURATION:
+                return Value::duration(static_cast<int64_t>(entry->data));
+            case Value::DataType::BYTES:
+                return Value::bytes(entry->data);
+            default:
+                return Value();
         }
+    }
 
-        // write out file
-        if (!serializeFilePath.empty()) {
-            std::ofstream ofd(serializeFilePath);
-            if (ofd.good()) {
-                ofd << outStr;
-                ofd.close();
-            }
+    MINICONF_INLINE const char* Config::SharedSegment::stringData(const std::string& flag, size_t& length) const
+    {
+        const Entry* entry = find(flag);
+        const Value::DataType type = entry ? static_cast<Value::DataType>(entry->type) : Value::DataType::UNKNOWN;
+        if (type != Value::DataType::STRING && type != Value::DataType::CHOICE) {
+            length = 0;
+            return nullptr;
         }
-        return outStr;
+        length = static_cast<size_t>(entry->length);
+        return _data + entry->data;
     }
 
-    void Config::config(const std::string& configPath)
+#ifdef MINICONF_HAS_STRING_VIEW
+    MINICONF_INLINE std::string_view Config::SharedSegment::stringView(const std::string& flag) const
     {
-        // read content of the file
-        std::ifstream ifd(configPath, std::ios::in | std::ios::binary);
-        std::string configContent = "";
-        if (ifd) {
-            configContent = std::string((std::istreambuf_iterator<char>(ifd)), std::istreambuf_iterator<char>());
-        }
+        size_t length = 0;
+        const char* data = stringData(flag, length);
+        return data ? std::string_view(data, length) : std::string_view();
+    }
+#endif
 
-        // extract extension
-        std::string extension = "";
-        size_t lastDot = configPath.find_last_of(".");
-        if (lastDot != std::string::npos) {
-            extension = configPath.substr(lastDot + 1);
+    MINICONF_INLINE const char* Config::SharedSegment::map(const std::string& name, size_t& size)
+    {
+        int fd = shm_open(name.c_str(), O_RDONLY, 0);
+        if (fd < 0) {
+            return nullptr;
         }
-
-        // load config according to extension
-        // default is json
-#ifdef MINICONF_JSON_SUPPORT
-        if (extension == "json" || extension == "JSON") {
-            loadJSON(configContent);
-            return;
-        } else if (extension == "csv" || extension == "CSV") {
-            loadCSV(configContent);
-            return;
-        } else {
-            loadJSON(configContent);
+        struct stat st;
+        void* addr = MAP_FAILED;
+        if (fstat(fd, &st) == 0 && st.st_size > 0) {
+            size = static_cast<size_t>(st.st_size);
+            addr = mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
         }
-#else
-        loadCSV(configContent);
-#endif
-
-        return;
+        close(fd);
+        return (addr == MAP_FAILED) ? nullptr : static_cast<const char*>(addr);
     }
 
-    bool Config::loadCSV(const std::string& CSVStr)
+    MINICONF_INLINE const Config::SharedSegment::Entry* Config::SharedSegment::find(const std::string& flag) const
     {
-        std::stringstream ss(CSVStr);
-        bool success = true;
-        while (ss.good()){
-            std::string templine;
-            std::getline(ss, templine);
-            std::stringstream lss(templine);
-            if (templine.empty()){
-                continue; 
-            }
-            while (lss.good()){
-                std::string sflag;
-                std::string svalue;
-                std::getline(lss, sflag, ',');
-                std::getline(lss, svalue, ',');
-                if (svalue.empty()){
-                    continue; 
-                    success = false;
-                }
-                // check if options exists
-                if (findOption(sflag)){
-                    // parse the default data type
-                    _optionValues[sflag] = parseValue(svalue.c_str(), _options[sflag].type()); 
-                    log(LogLevel::INFO, std::string(sflag), "value is loaded from config");
-                } else {
-                    // parse string when the flag does not exist in the original configuration
-                    _optionValues[sflag] = parseValue(svalue.c_str(), Value::DataType::STRING);
-                    log(LogLevel::INFO, std::string(sflag), "value is not defined in config, parsed as a string value");
-                }
-            }
+        if (!_data) {
+            return nullptr;
         }
-        return success;
-    }
- 
-#ifdef MINICONF_JSON_SUPPORT
-    bool Config::getJSONValue(const picojson::value *v, const std::string& flag){
-        bool success = true;
-        if (findOption(flag)){
-            Config::Option opt = _options[flag];
-            if (opt.type() == Value::DataType::INT && v->is<double>()){
-                _optionValues[flag] = static_cast<int>(v->get<double>());
-            } else if (opt.type() == Value::DataType::NUMBER && v->is<double>()) {
-                _optionValues[flag] = v->get<double>();
-            } else if (opt.type() == Value::DataType::BOOL && v->is<bool>()) {
-                _optionValues[flag] = v->get<bool>();
-            } else if (opt.type() == Value::DataType::STRING && v->is<std::string>()) {
-                _optionValues[flag] = v->get<std::string>();
-            } else {
-                log(LogLevel::WARNING, flag, "Unable to parse the option from config file, flag = " + flag);
-                success = false;
+        // binary search over the entries, which are sorted as std::string
+        const Entry* entries = reinterpret_cast<const Entry*>(_data + sizeof(Header));
+        size_t low = 0;
+        size_t high = size();
+        while (low < high) {
+            size_t mid = low + (high - low) / 2;
+            int cmp = flag.compare(0, std::string::npos, _data + entries[mid].flag, entries[mid].flagLength);
+            if (cmp == 0) {
+                return &(entries[mid]);
             }
-        }
-        // stray options
-        else 
-        {
-            if (v->is<double>()){
-                _optionValues[flag] = v->get<double>();
-            } 
-            else if (v->is<bool>()) {
-                _optionValues[flag] = v->get<bool>();
-            } else if (v->is<std::string>()) {
-                _optionValues[flag] = v->get<std::string>();
+            if (cmp < 0) {
+                high = mid;
             } else {
-                log(LogLevel::WARNING, flag, "Unable to parse the option from config file.");
-                success = false;
-            }
-        }
-        return success;
-    }
-
-    bool Config::parseJSON(const picojson::value *v, const std::string& flag){
-        if (v->is<double>() || v->is<bool>() || v->is<std::string>()){
-            return getJSONValue(v, flag);
-        } else if (v->is<picojson::object>()){
-            bool success = true;
-            for (auto objItem: v->get<picojson::object>()){
-                success = success && parseJSON(&(objItem.second), flag + (flag.empty() ? "" : ".") + objItem.first);
-            }
-            return success;
-        } else if (v->is<picojson::array>()){
-            for (auto arrayItem : v->get<picojson::array>()){
-                // print array, not supported yet
+                low = mid + 1;
             }
-        } else {
-            log(LogLevel::WARNING, flag, "Unable to parse JSON, abort, flag = " + flag);
-            return false;
         }
-        return false;
-    }
-
-    bool Config::loadJSON(const std::string& JSONStr)
-    {
-        picojson::value json;
-        picojson::parse(json, JSONStr);
-        return parseJSON(&json, "");
+        return nullptr;
     }
 #endif
 
+#endif // MINICONF_DEFINITIONS
 }
 
 // TODO: Stray arguments
-// TODO: Support choice (value must be chosen form a list)
 // TODO: Beautiful print, in help() and usage(), instead of printf()
 // TODO: Support array
 // TODO: Switch to JSON backend?
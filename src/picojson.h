@@ -33,7 +33,10 @@
 #include <cstdlib>
 #include <cstring>
 #include <cstddef>
+// PICOJSON_NO_IOSTREAM leaves out the stream operators, and with them the static initialization of iostream
+#ifndef PICOJSON_NO_IOSTREAM
 #include <iostream>
+#endif
 #include <iterator>
 #include <limits>
 #include <map>
@@ -115,11 +118,58 @@ namespace picojson {
   };
 
   struct null {};
+
+#ifdef PICOJSON_USE_FLAT_OBJECT
+  class value;
+
+  // An insertion-ordered object stored in a vector, objects with many keys are indexed by a hash table.
+  // Unlike std::map, references to the values are invalidated when a key is added.
+  class flat_object {
+  public:
+    typedef std::string key_type;
+    typedef value mapped_type;
+    typedef std::pair<std::string, value> value_type;
+    typedef std::vector<value_type>::iterator iterator;
+    typedef std::vector<value_type>::const_iterator const_iterator;
+    typedef std::vector<value_type>::size_type size_type;
+    // objects with this number of keys or more are indexed
+    enum { INDEX_THRESHOLD = 16 };
+    iterator begin();
+    iterator end();
+    const_iterator begin() const;
+    const_iterator end() const;
+    size_type size() const;
+    bool empty() const;
+    iterator find(const std::string& key);
+    const_iterator find(const std::string& key) const;
+    size_type count(const std::string& key) const;
+    value& operator[](const std::string& key);
+    std::pair<iterator, bool> insert(const value_type& item);
+    size_type erase(const std::string& key);
+    void clear();
+    void shrink_to_fit();
+    bool operator==(const flat_object& other) const;
+    bool operator!=(const flat_object& other) const;
+  private:
+    static size_t hash(const std::string& key);
+    size_type lookup(const std::string& key) const;
+    void place(size_type position);
+    void added();
+    void rebuild();
+    std::vector<value_type> items_;
+    // open addressing table of item positions plus one, zero marks an empty slot
+    std::vector<unsigned> index_;
+  };
+#endif
   
   class value {
   public:
     typedef std::vector<value> array;
+#ifdef PICOJSON_USE_FLAT_OBJECT
+    typedef flat_object object;
+#else
     typedef std::map<std::string, value> object;
+#endif
     union _storage {
       bool boolean_;
       double number_;
@@ -324,7 +374,7 @@ namespace picojson {
   GET(array, *u_.array_)
   GET(object, *u_.object_)
 #ifdef PICOJSON_USE_INT64
-  GET(double, (type_ == int64_type && (const_cast<value*>(this)->type_ = number_type, const_cast<value*>(this)->u_.number_ = u_.int64_), u_.number_))
+  GET(double, (type_ == int64_type && (const_cast<value*>(this)->type_ = number_type, (const_cast<value*>(this)->u_.number_ = u_.int64_)), u_.number_))
   GET(int64_t, u_.int64_)
 #else
   GET(double, u_.number_)
@@ -399,6 +449,9 @@ namespace picojson {
     }
 #endif
     case number_type:    {
+#ifdef PICOJSON_NUMBER_TO_STR
+      return PICOJSON_NUMBER_TO_STR(u_.number_);
+#else
       char buf[256];
       double tmp;
       SNPRINTF(buf, sizeof(buf), fabs(u_.number_) < (1ULL << 53) && modf(u_.number_, &tmp) == 0 ? "%.f" : "%.17g", u_.number_);
@@ -414,6 +467,7 @@ namespace picojson {
       }
 #endif
       return buf;
+#endif
     }
     case string_type:    return *u_.string_;
     case array_type:     return "array";
@@ -727,6 +781,11 @@ namespace picojson {
     return in.expect(']') && ctx.parse_array_stop(idx);
   }
   
+#ifdef PICOJSON_USE_FLAT_OBJECT
+  // called when all items of an object are parsed, see the overload for default_parse_context
+  template <typename Context> inline void _parse_object_stop(Context&) {}
+#endif
+
   template <typename Context, typename Iter> inline bool _parse_object(Context& ctx, input<Iter>& in) {
     if (! ctx.parse_object_start()) {
       return false;
@@ -745,7 +804,15 @@ namespace picojson {
 	return false;
       }
     } while (in.expect(','));
+#ifdef PICOJSON_USE_FLAT_OBJECT
+    if (! in.expect('}')) {
+      return false;
+    }
+    _parse_object_stop(ctx);
+    return true;
+#else
     return in.expect('}');
+#endif
   }
   
   template <typename Iter> inline std::string _parse_number(input<Iter>& in) {
@@ -891,11 +958,23 @@ namespace picojson {
       default_parse_context ctx(&o[key]);
       return _parse(ctx, in);
     }
+#ifdef PICOJSON_USE_FLAT_OBJECT
+    void parse_object_stop() {
+      out_->get<object>().shrink_to_fit();
+    }
+#endif
   private:
     default_parse_context(const default_parse_context&);
     default_parse_context& operator=(const default_parse_context&);
   };
 
+#ifdef PICOJSON_USE_FLAT_OBJECT
+  // parsed objects do not keep the spare capacity of their vectors
+  inline void _parse_object_stop(default_parse_context& ctx) {
+    ctx.parse_object_stop();
+  }
+#endif
+
   class null_parse_context {
   public:
     struct dummy_str {
@@ -963,12 +1042,14 @@ namespace picojson {
     return err;
   }
 
+#ifndef PICOJSON_NO_IOSTREAM
   inline std::string parse(value& out, std::istream& is) {
     std::string err;
     parse(out, std::istreambuf_iterator<char>(is.rdbuf()),
 	  std::istreambuf_iterator<char>(), &err);
     return err;
   }
+#endif
   
   template <typename T> struct last_error_t {
     static std::string s;
@@ -1005,6 +1086,142 @@ namespace picojson {
   inline bool operator!=(const value& x, const value& y) {
     return ! (x == y);
   }
+
+#ifdef PICOJSON_USE_FLAT_OBJECT
+  inline flat_object::iterator flat_object::begin() { return items_.begin(); }
+  inline flat_object::iterator flat_object::end() { return items_.end(); }
+  inline flat_object::const_iterator flat_object::begin() const { return items_.begin(); }
+  inline flat_object::const_iterator flat_object::end() const { return items_.end(); }
+  inline flat_object::size_type flat_object::size() const { return items_.size(); }
+  inline bool flat_object::empty() const { return items_.empty(); }
+
+  inline flat_object::iterator flat_object::find(const std::string& key) {
+    return items_.begin() + lookup(key);
+  }
+
+  inline flat_object::const_iterator flat_object::find(const std::string& key) const {
+    return items_.begin() + lookup(key);
+  }
+
+  inline flat_object::size_type flat_object::count(const std::string& key) const {
+    return lookup(key) != items_.size() ? 1 : 0;
+  }
+
+  inline value& flat_object::operator[](const std::string& key) {
+    size_type i = lookup(key);
+    if (i == items_.size()) {
+      items_.push_back(value_type(key, value()));
+      added();
+    }
+    return items_[i].second;
+  }
+
+  inline std::pair<flat_object::iterator, bool> flat_object::insert(const value_type& item) {
+    size_type i = lookup(item.first);
+    if (i != items_.size()) {
+      return std::make_pair(items_.begin() + i, false);
+    }
+    items_.push_back(item);
+    added();
+    return std::make_pair(items_.begin() + i, true);
+  }
+
+  inline flat_object::size_type flat_object::erase(const std::string& key) {
+    size_type i = lookup(key);
+    if (i == items_.size()) {
+      return 0;
+    }
+    items_.erase(items_.begin() + i);
+    rebuild();
+    return 1;
+  }
+
+  inline void flat_object::clear() {
+    items_.clear();
+    index_.clear();
+  }
+
+  inline void flat_object::shrink_to_fit() {
+    items_.shrink_to_fit();
+  }
+
+  inline bool flat_object::operator==(const flat_object& other) const {
+    if (items_.size() != other.items_.size()) {
+      return false;
+    }
+    for (const_iterator i = begin(); i != end(); ++i) {
+      const_iterator j = other.find(i->first);
+      if (j == other.end() || j->second != i->second) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  inline bool flat_object::operator!=(const flat_object& other) const {
+    return ! (*this == other);
+  }
+
+  inline size_t flat_object::hash(const std::string& key) {
+    // FNV-1a
+    size_t h = 2166136261u;
+    for (size_t i = 0; i < key.size(); ++i) {
+      h = (h ^ static_cast<unsigned char>(key[i])) * 16777619u;
+    }
+    return h;
+  }
+
+  inline flat_object::size_type flat_object::lookup(const std::string& key) const {
+    if (index_.empty()) {
+      for (size_type i = 0; i < items_.size(); ++i) {
+        if (items_[i].first == key) {
+          return i;
+        }
+      }
+      return items_.size();
+    }
+    const size_t mask = index_.size() - 1;
+    for (size_t slot = hash(key) & mask; index_[slot] != 0; slot = (slot + 1) & mask) {
+      if (items_[index_[slot] - 1].first == key) {
+        return index_[slot] - 1;
+      }
+    }
+    return items_.size();
+  }
+
+  inline void flat_object::place(size_type position) {
+    const size_t mask = index_.size() - 1;
+    size_t slot = hash(items_[position].first) & mask;
+    while (index_[slot] != 0) {
+      slot = (slot + 1) & mask;
+    }
+    index_[slot] = static_cast<unsigned>(position + 1);
+  }
+
+  inline void flat_object::added() {
+    // the table is kept at most half full
+    if (index_.empty() ? items_.size() >= INDEX_THRESHOLD : items_.size() * 2 > index_.size()) {
+      rebuild();
+    } else if (! index_.empty()) {
+      place(items_.size() - 1);
+    }
+  }
+
+  inline void flat_object::rebuild() {
+    index_.clear();
+    if (items_.size() < INDEX_THRESHOLD) {
+      return;
+    }
+    size_t capacity = 2 * INDEX_THRESHOLD;
+    while (capacity < items_.size() * 2) {
+      capacity *= 2;
+    }
+    index_.assign(capacity, 0);
+    for (size_type i = 0; i < items_.size(); ++i) {
+      place(i);
+    }
+  }
+#endif
 }
 
 #if !PICOJSON_USE_RVALUE_REFERENCE 
@@ -1016,6 +1233,7 @@ namespace std {
 }
 #endif
 
+#ifndef PICOJSON_NO_IOSTREAM
 inline std::istream& operator>>(std::istream& is, picojson::value& x)
 {
   picojson::set_last_error(std::string());
@@ -1032,6 +1250,7 @@ inline std::ostream& operator<<(std::ostream& os, const picojson::value& x)
   x.serialize(std::ostream_iterator<char>(os));
   return os;
 }
+#endif
 #ifdef _MSC_VER
     #pragma warning(pop)
 #endif
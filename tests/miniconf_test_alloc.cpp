@@ -0,0 +1,191 @@
+/*
+ * miniconf test: allocation budgets
+ *
+ * Counts the heap allocations of common operations with a replaced global
+ * operator new, and compares them with allocation budgets. Allocations of
+ * loading config files are counted per line (CSV) or per key (JSON) for a few
+ * file sizes, so that any growth which is not linear shows up. The program
+ * returns 1 if any count exceeds its budget, so that ctest fails.
+ *
+ * The first argument selects a group of checks ("values", "parse" or "files"),
+ * all the groups are checked without an argument.
+ */
+
+#include <cstdio>
+#include <cstring>
+#include <miniconf.h>
+#define MINICONF_BENCH_COUNT_ALLOCATIONS
+#include "bench_common.h"
+
+using miniconf::bench::allocationCount;
+
+// Number of failed budgets
+static int failures = 0;
+
+// Prints the allocations of an operation and checks them against the budget
+static void report(const char* name, double allocations, double budget, const char* unit = "")
+{
+    bool failed = allocations > budget;
+    failures += failed ? 1 : 0;
+    printf("| %-44s | %10.2f%-9s | %10.2f | %-6s |\n", name, allocations, unit, budget, failed ? "FAILED" : "ok");
+}
+
+// Counts the allocations of a function
+template <typename Func>
+static size_t countAllocations(Func func)
+{
+    size_t before = allocationCount;
+    func();
+    return allocationCount - before;
+}
+
+// Writes a file, returns false on failure
+static bool writeFile(const char* path, const std::string& content)
+{
+    FILE* fd = fopen(path, "wb");
+    if (!fd) {
+        fprintf(stderr, "Unable to write \"%s\"\n", path);
+        return false;
+    }
+    fwrite(content.data(), 1, content.size(), fd);
+    fclose(fd);
+    return true;
+}
+
+// Defines the options of the benchmark
+static void defineOptions(miniconf::Config& conf)
+{
+    conf.description("allocation benchmark");
+    conf.option("numOpt").shortflag("n").defaultValue(3.14).required(false).description("A number value");
+    conf.option("intOpt").shortflag("i").defaultValue(42).required(false).description("An integer value");
+    conf.option("boolOpt").shortflag("b").defaultValue(false).required(false).description("A boolean value");
+    conf.option("strOpt").shortflag("s").defaultValue("a string longer than the inline buffer").required(false).description("A string value");
+    conf.log(miniconf::Config::LogLevel::NONE);
+}
+
+// Checks reads and copies of values
+static void checkValues(double& number)
+{
+    miniconf::Config conf;
+    defineOptions(conf);
+    const std::string numFlag = "numOpt";
+    const std::string strFlag = "strOpt";
+
+    report("Config::value() typed read", static_cast<double>(countAllocations([&]() {
+        number += conf.value(numFlag).getNumber();
+    })), 0);
+    report("Config::value() string read", static_cast<double>(countAllocations([&]() {
+        number += static_cast<double>(conf.value(strFlag).length());
+    })), 0);
+    miniconf::Value longString("a string longer than the inline buffer");
+    const miniconf::Config::Option& option = conf.option(numFlag);
+#ifdef MINICONF_HAS_STRING_VIEW
+    report("Option metadata read", static_cast<double>(countAllocations([&]() {
+        number += static_cast<double>(option.flagView().size() + option.shortflagView().size() + option.descriptionView().size());
+        number += option.defaultValue().getNumber() + (option.required() ? 1 : 0);
+    })), 0);
+#endif
+    report("Value copy of a long string", static_cast<double>(countAllocations([&]() {
+        miniconf::Value copy(longString);
+        number += static_cast<double>(copy.length());
+    })), 0);
+    report("Value assignment of an integer", static_cast<double>(countAllocations([&]() {
+        miniconf::Value value;
+        value = 5;
+        number += value.getInt();
+    })), 0);
+    report("Overlay with 2 overrides", static_cast<double>(countAllocations([&]() {
+        miniconf::Config::Overlay overlay(conf);
+        overlay.set(numFlag, miniconf::Value(1.5)).set("intOpt", miniconf::Value(7));
+        number += overlay.value(numFlag).getNumber();
+    })), 0);
+}
+
+// Checks parsing command line arguments
+static void checkParse()
+{
+    const char* args[] = {"miniconf_test_alloc", "--numOpt", "2.5", "-i", "7", "-b", "--strOpt", "command line string"};
+    miniconf::Config parsed;
+    defineOptions(parsed);
+    report("Config::parse() of 4 arguments", static_cast<double>(countAllocations([&]() {
+        parsed.parse(8, const_cast<char**>(args));
+    })), 8);
+
+    // the allocations of parsing do not depend on the number of options
+    miniconf::Config many;
+    defineOptions(many);
+    char flag[32];
+    for (int i = 0; i < 1000; ++i) {
+        snprintf(flag, sizeof(flag), "option%04d", i);
+        many.option(flag).defaultValue(i).description("An integer value");
+    }
+    report("Config::parse() of 4 arguments, 1004 options", static_cast<double>(countAllocations([&]() {
+        many.parse(8, const_cast<char**>(args));
+    })), 8);
+}
+
+// Checks loading config files, allocations per line / key
+static bool checkFiles()
+{
+    const char* csvPath = "miniconf_test_alloc.csv";
+    const char* jsonPath = "miniconf_test_alloc.json";
+    for (int lines = 1000; lines <= 4000; lines *= 2) {
+        std::string csv;
+        std::string json = "{";
+        char buffer[128];
+        for (int i = 0; i < lines; ++i) {
+            snprintf(buffer, sizeof(buffer), "section%d.option%06d,%d\n", i % 10, i, i);
+            csv += buffer;
+            snprintf(buffer, sizeof(buffer), "%s\"option%06d\": %d", (i == 0) ? "" : ",", i, i);
+            json += buffer;
+        }
+        json += "}";
+        if (!writeFile(csvPath, csv) || !writeFile(jsonPath, json)) {
+            return false;
+        }
+        char name[64];
+        snprintf(name, sizeof(name), "Config::config() CSV, %d lines", lines);
+        report(name, static_cast<double>(countAllocations([&]() {
+            miniconf::Config loaded;
+            loaded.log(miniconf::Config::LogLevel::NONE);
+            loaded.config(csvPath);
+        })) / lines, 4, " per line");
+        snprintf(name, sizeof(name), "Config::config() JSON, %d keys", lines);
+        report(name, static_cast<double>(countAllocations([&]() {
+            miniconf::Config loaded;
+            loaded.log(miniconf::Config::LogLevel::NONE);
+            loaded.config(jsonPath);
+        })) / lines, 2.5, " per key");
+    }
+    remove(csvPath);
+    remove(jsonPath);
+    return true;
+}
+
+/* Main file */
+int main(int argc, char** argv)
+{
+    const char* group = (argc > 1) ? argv[1] : "";
+    if (group[0] && strcmp(group, "values") != 0 && strcmp(group, "parse") != 0 && strcmp(group, "files") != 0) {
+        fprintf(stderr, "Unknown group \"%s\"\n", group);
+        return 1;
+    }
+    printf("|----------------------------------------------|-----------------------|------------|--------|\n");
+    printf("|                  OPERATION                   |      ALLOCATIONS      |   BUDGET   | STATUS |\n");
+    printf("|----------------------------------------------|-----------------------|------------|--------|\n");
+
+    double number = 0.0;
+    if (!group[0] || strcmp(group, "values") == 0) {
+        checkValues(number);
+    }
+    if (!group[0] || strcmp(group, "parse") == 0) {
+        checkParse();
+    }
+    if ((!group[0] || strcmp(group, "files") == 0) && !checkFiles()) {
+        return 1;
+    }
+
+    printf("|----------------------------------------------|-----------------------|------------|--------|\n");
+    printf("\n%s\n", failures ? "Some allocation budgets are exceeded" : "All allocation budgets are met");
+    return (failures || number < 0) ? 1 : 0;
+}
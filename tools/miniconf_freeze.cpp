@@ -0,0 +1,232 @@
+/* 
+ * miniconf freeze
+ *
+ * Loads a config file (JSON or CSV) via Config::config() and generates a C++
+ * header of constexpr values. Dotted keys are mapped to nested namespaces, 
+ * e.g. "part2.subpart1.value1" becomes part2::subpart1::value1.
+ *
+ * Values are typed as they are loaded at runtime without any option defined,
+ * i.e. JSON numbers are doubles and all CSV values are strings, unless a schema 
+ * file in the format of miniconf_schemagen declares the types of the options.
+ * Only the values of the config file are frozen, not the defaults of the schema.
+ */
+
+#include <cstdio>
+#include <cstring>
+#include <miniconf.h>
+#include "miniconf_tools.h"
+
+using miniconf::tools::quote;
+using miniconf::tools::identifier;
+
+// A namespace (with children) or a value of the generated header
+struct Node {
+    const miniconf::Value* value;
+    std::map<std::string, Node> children;
+    Node() : value(nullptr) {}
+};
+
+// Inserts a value into the tree of namespaces
+static bool insert(Node& root, const std::string& flag, const miniconf::Value* value)
+{
+    Node* node = &root;
+    size_t begin = 0;
+    while (true) {
+        size_t dot = flag.find('.', begin);
+        std::string name = identifier(flag.substr(begin, (dot == std::string::npos) ? std::string::npos : dot - begin));
+        node = &(node->children[name]);
+        if (dot == std::string::npos) {
+            break;
+        }
+        if (node->value) {
+            fprintf(stderr, "Key \"%s\" is both a value and a namespace\n", flag.c_str());
+            return false;
+        }
+        begin = dot + 1;
+    }
+    if (node->value || !node->children.empty()) {
+        fprintf(stderr, "Key \"%s\" is defined more than once, or it is also a namespace\n", flag.c_str());
+        return false;
+    }
+    node->value = value;
+    return true;
+}
+
+// Reads the types of the options of a schema file, and defines the options with them
+static bool declareTypes(miniconf::Config& conf, const std::string& path)
+{
+    FILE* fd = fopen(path.c_str(), "rb");
+    if (!fd) {
+        fprintf(stderr, "Unable to open schema file \"%s\"\n", path.c_str());
+        return false;
+    }
+    std::string content;
+    char buffer[4096];
+    size_t n = 0;
+    while ((n = fread(buffer, 1, sizeof(buffer), fd)) > 0) {
+        content.append(buffer, n);
+    }
+    fclose(fd);
+
+    picojson::value root;
+    std::string err = picojson::parse(root, content);
+    if (!err.empty() || !root.is<picojson::object>() || !root.get("options").is<picojson::array>()) {
+        fprintf(stderr, "Invalid schema file \"%s\" %s\n", path.c_str(), err.c_str());
+        return false;
+    }
+    for (auto && item : root.get("options").get<picojson::array>()) {
+        std::string flag = item.get("flag").is<std::string>() ? item.get("flag").get<std::string>() : "";
+        std::string type = item.get("type").is<std::string>() ? item.get("type").get<std::string>() : "";
+        // the default value only gives the type, it is not frozen
+        miniconf::Value typed = (type == "INT") ? miniconf::Value(0) :
+            (type == "NUMBER") ? miniconf::Value(0.0) :
+            (type == "BOOLEAN") ? miniconf::Value(false) :
+            (type == "STRING") ? miniconf::Value("") :
+            (type == "INT64") ? miniconf::Value(static_cast<int64_t>(0)) :
+            (type == "UINT64") ? miniconf::Value(static_cast<uint64_t>(0)) :
+            (type == "DURATION") ? miniconf::Value::duration(0) :
+            (type == "BYTES") ? miniconf::Value::bytes(0) : miniconf::Value();
+        if (flag.empty() || typed.isEmpty()) {
+            fprintf(stderr, "Option \"%s\" has an unsupported type \"%s\" in \"%s\"\n", flag.c_str(), type.c_str(), path.c_str());
+            return false;
+        }
+        conf.option(flag).defaultValue(std::move(typed));
+    }
+    return true;
+}
+
+// Generates the literal of a signed 64-bit integer, the minimum has no literal
+static std::string int64Literal(int64_t value)
+{
+    if (value == INT64_MIN) {
+        return "(-9223372036854775807LL - 1)";
+    }
+    return std::to_string(value) + "LL";
+}
+
+// Generates the constexpr declaration of a value, returns an empty string if the value is invalid
+static std::string declaration(const std::string& name, const miniconf::Value& value)
+{
+    char number[miniconf::NUMBER_BUFFER_SIZE];
+    switch (value.type()) {
+        case miniconf::Value::DataType::INT:
+            return "constexpr int " + name + " = " + std::to_string(value.getInt()) + ";";
+        case miniconf::Value::DataType::NUMBER:
+            miniconf::formatNumber(value.getNumber(), number);
+            // keep it a floating point literal
+            return "constexpr double " + name + " = " + number + (strpbrk(number, ".e") ? "" : ".0") + ";";
+        case miniconf::Value::DataType::BOOL:
+            return "constexpr bool " + name + " = " + (value.getBoolean() ? "true" : "false") + ";";
+        case miniconf::Value::DataType::STRING:
+            return "constexpr const char* " + name + " = " + quote(value.getString()) + ";";
+        case miniconf::Value::DataType::INT64:
+            return "constexpr std::int64_t " + name + " = " + int64Literal(value.getInt64()) + ";";
+        case miniconf::Value::DataType::UINT64:
+            return "constexpr std::uint64_t " + name + " = " + std::to_string(value.getUInt64()) + "ULL;";
+        case miniconf::Value::DataType::DURATION:
+            return "constexpr std::chrono::nanoseconds " + name + " = std::chrono::nanoseconds(" + int64Literal(value.getDuration()) + ");";
+        case miniconf::Value::DataType::BYTES:
+            return "constexpr std::uint64_t " + name + " = " + std::to_string(value.getBytes()) + "ULL; // bytes";
+        case miniconf::Value::DataType::CHOICE:
+            // the name of the choice, its code depends on the definition of the option
+            return "constexpr const char* " + name + " = " + quote(value.getString()) + ";";
+        default:
+            return "";
+    }
+}
+
+// Writes the namespaces and values of a node, returns false if a value cannot be frozen
+static bool write(FILE* fd, const Node& node, int indent)
+{
+    for (auto && child : node.children) {
+        if (child.second.value) {
+            std::string decl = declaration(child.first, *child.second.value);
+            if (decl.empty()) {
+                fprintf(stderr, "Value \"%s\" is invalid or of an unknown type, it cannot be frozen\n", child.first.c_str());
+                return false;
+            }
+            fprintf(fd, "%*s%s\n", indent, "", decl.c_str());
+        } else {
+            fprintf(fd, "%*snamespace %s\n%*s{\n", indent, "", child.first.c_str(), indent, "");
+            if (!write(fd, child.second, indent + 4)) {
+                return false;
+            }
+            fprintf(fd, "%*s}\n", indent, "");
+        }
+    }
+    return true;
+}
+
+/* Main file */
+int main(int argc, char** argv)
+{
+    miniconf::Config conf;
+    conf.description("Generates a C++ header of constexpr values from a config file");
+    conf.option("input").shortflag("i").defaultValue("").required(true).description("Input config file (JSON/CSV)");
+    conf.option("output").shortflag("o").defaultValue("").required(true).description("Output header file");
+    conf.option("namespace").shortflag("n").defaultValue("frozen").required(false).description("Namespace of the generated code");
+    conf.option("schema").shortflag("s").defaultValue("").required(false).description("Schema file which declares the types of the values (JSON)");
+    conf.enableConfig(false);
+    conf.log(miniconf::Config::LogLevel::ERROR);
+    if (!conf.parse(argc, argv)) {
+        return 1;
+    }
+    std::string inputPath = conf.value("input").getString();
+    std::string outputPath = conf.value("output").getString();
+    std::string ns = conf.value("namespace").getString();
+    std::string schemaPath = conf.value("schema").getString();
+    if (inputPath.empty() || outputPath.empty()) {
+        conf.usage(stderr);
+        return 1;
+    }
+    if (!miniconf::tools::isIdentifier(ns)) {
+        fprintf(stderr, "Namespace \"%s\" is not a C++ identifier\n", ns.c_str());
+        return 1;
+    }
+
+    // load the config file as it is loaded at runtime
+    miniconf::Config frozen;
+    frozen.enableHelp(false);
+    frozen.enableConfig(false);
+    frozen.log(miniconf::Config::LogLevel::ERROR);
+    if (!schemaPath.empty() && !declareTypes(frozen, schemaPath)) {
+        return 1;
+    }
+    // a missing, unreadable or truncated file fails the build instead of freezing a part of it
+    if (!frozen.config(inputPath)) {
+        frozen.log(stderr);
+        fprintf(stderr, "Unable to load config file \"%s\"\n", inputPath.c_str());
+        return 1;
+    }
+    std::map<std::string, const miniconf::Value*> values;
+    frozen.values(values);
+
+    Node root;
+    for (auto && v : values) {
+        if (frozen.source(v.first) == miniconf::Config::Source::DEFAULT) {
+            continue;
+        }
+        if (!insert(root, v.first, v.second)) {
+            return 1;
+        }
+    }
+
+    FILE* fd = fopen(outputPath.c_str(), "wb");
+    if (!fd) {
+        fprintf(stderr, "Unable to write header file \"%s\"\n", outputPath.c_str());
+        return 1;
+    }
+    std::string guard = miniconf::tools::includeGuard("MINICONF_FROZEN", ns);
+    fprintf(fd, "/*\n * Generated by miniconf_freeze from \"%s\", do not edit.\n */\n\n", inputPath.c_str());
+    fprintf(fd, "#ifndef %s\n#define %s\n\n", guard.c_str(), guard.c_str());
+    fprintf(fd, "#include <chrono>\n#include <cstdint>\n\n");
+    fprintf(fd, "namespace %s\n{\n", ns.c_str());
+    bool success = write(fd, root, 4);
+    fprintf(fd, "}\n\n#endif // %s\n", guard.c_str());
+    fclose(fd);
+    if (!success) {
+        remove(outputPath.c_str());
+        return 1;
+    }
+    return 0;
+}
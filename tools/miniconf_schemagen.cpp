@@ -0,0 +1,372 @@
+/* 
+ * miniconf schema generator
+ *
+ * Reads a declarative schema file (JSON) and generates a C++ header which 
+ * defines the options of the schema, a minimal perfect hash over their long
+ * and short flags, and typed accessors of the option values.
+ *
+ * The schema file contains an array of options, for example:
+ *
+ *     {
+ *         "options": [
+ *             { "flag": "numOpt", "shortflag": "n", "type": "NUMBER", "default": 3.14, "description": "A number value" },
+ *             { "flag": "strOpt", "shortflag": "s", "type": "STRING", "required": true, "description": "A string value" }
+ *         ]
+ *     }
+ *
+ * Supported types are "INT", "NUMBER", "BOOLEAN", "STRING", "INT64", "UINT64", "DURATION"
+ * and "BYTES". Defaults of durations and byte sizes are strings with units (e.g. "250ms"),
+ * or numbers in nanoseconds and bytes.
+ */
+
+#include <cstdio>
+#include <algorithm>
+#include <set>
+#include <miniconf.h>
+#include "miniconf_tools.h"
+
+using miniconf::tools::quote;
+using miniconf::tools::identifier;
+using miniconf::tools::blockComment;
+
+// One option of the schema
+struct SchemaOption {
+    std::string flag;
+    std::string shortflag;
+    std::string description;
+    std::string type;
+    bool required;
+    picojson::value defaultValue;
+};
+
+// A minimal perfect hash, keys are mapped to slots by the displacement of their buckets
+struct PerfectHash {
+    std::vector<uint32_t> displacements;
+    std::vector<int> slots;
+};
+
+// Builds a minimal perfect hash, the slots store the indices of the keys
+static bool buildPerfectHash(const std::vector<std::string>& keys, const std::vector<int>& indices, PerfectHash& ph)
+{
+    const size_t n = keys.size();
+    ph.displacements.assign(std::max<size_t>(n, 1), 0);
+    ph.slots.assign(std::max<size_t>(n, 1), -1);
+    if (n == 0) {
+        return true;
+    }
+
+    // group the keys into buckets, larger buckets are placed first
+    std::vector<std::vector<size_t>> buckets(n);
+    for (size_t i = 0; i < n; ++i) {
+        buckets[miniconf::Config::FlagTable::hash(keys[i].c_str(), keys[i].size(), 0) % n].push_back(i);
+    }
+    std::vector<size_t> order(n);
+    for (size_t b = 0; b < n; ++b) {
+        order[b] = b;
+    }
+    std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+        return buckets[a].size() > buckets[b].size();
+    });
+
+    // search for a displacement which places all the keys of a bucket in free slots
+    for (size_t b : order) {
+        if (buckets[b].empty()) {
+            break;
+        }
+        bool placed = false;
+        for (uint32_t d = 1; d < (1u << 24) && !placed; ++d) {
+            std::vector<size_t> taken;
+            placed = true;
+            for (size_t k : buckets[b]) {
+                size_t slot = miniconf::Config::FlagTable::hash(keys[k].c_str(), keys[k].size(), d) % n;
+                if (ph.slots[slot] >= 0 || std::find(taken.begin(), taken.end(), slot) != taken.end()) {
+                    placed = false;
+                    break;
+                }
+                taken.push_back(slot);
+            }
+            if (placed) {
+                for (size_t i = 0; i < taken.size(); ++i) {
+                    ph.slots[taken[i]] = indices[buckets[b][i]];
+                }
+                ph.displacements[b] = d;
+            }
+        }
+        if (!placed) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Checks if the default value of a type is stored as text and parsed when the options are defined
+static bool isParsedType(const std::string& type)
+{
+    return type == "INT64" || type == "UINT64" || type == "DURATION" || type == "BYTES";
+}
+
+// Gets the default value text of a parsed type, numbers are in nanoseconds and bytes for durations and byte sizes
+static std::string parsedText(const SchemaOption& o)
+{
+    const picojson::value& v = o.defaultValue;
+    if (v.is<std::string>()) {
+        return v.get<std::string>();
+    }
+    if (!v.is<double>()) {
+        return "0";
+    }
+    return v.to_str() + ((o.type == "DURATION") ? "ns" : "");
+}
+
+// Parses the default value of a parsed type
+static miniconf::Value parsedValue(const SchemaOption& o)
+{
+    miniconf::Value::DataType type = (o.type == "INT64") ? miniconf::Value::DataType::INT64 : 
+        (o.type == "UINT64") ? miniconf::Value::DataType::UINT64 : 
+        (o.type == "DURATION") ? miniconf::Value::DataType::DURATION : miniconf::Value::DataType::BYTES;
+    return miniconf::Value::parse(parsedText(o).c_str(), type);
+}
+
+// Reads the options from a schema file
+static bool readSchema(const std::string& path, std::vector<SchemaOption>& options)
+{
+    FILE* fd = fopen(path.c_str(), "rb");
+    if (!fd) {
+        fprintf(stderr, "Unable to open schema file \"%s\"\n", path.c_str());
+        return false;
+    }
+    std::string content;
+    char buffer[4096];
+    size_t n = 0;
+    while ((n = fread(buffer, 1, sizeof(buffer), fd)) > 0) {
+        content.append(buffer, n);
+    }
+    fclose(fd);
+
+    picojson::value root;
+    std::string err = picojson::parse(root, content);
+    if (!err.empty() || !root.is<picojson::object>() || !root.get("options").is<picojson::array>()) {
+        fprintf(stderr, "Invalid schema file \"%s\" %s\n", path.c_str(), err.c_str());
+        return false;
+    }
+    for (auto && item : root.get("options").get<picojson::array>()) {
+        SchemaOption o;
+        o.flag = item.get("flag").is<std::string>() ? item.get("flag").get<std::string>() : "";
+        o.shortflag = item.get("shortflag").is<std::string>() ? item.get("shortflag").get<std::string>() : "";
+        o.description = item.get("description").is<std::string>() ? item.get("description").get<std::string>() : "";
+        o.type = item.get("type").is<std::string>() ? item.get("type").get<std::string>() : "";
+        o.required = item.get("required").is<bool>() && item.get("required").get<bool>();
+        o.defaultValue = item.get("default");
+        if (o.flag.empty()) {
+            fprintf(stderr, "An option without flag is found in \"%s\"\n", path.c_str());
+            return false;
+        }
+        if (o.type != "INT" && o.type != "NUMBER" && o.type != "BOOLEAN" && o.type != "STRING" && 
+                o.type != "INT64" && o.type != "UINT64" && o.type != "DURATION" && o.type != "BYTES") {
+            fprintf(stderr, "Option \"%s\" has an unsupported type \"%s\"\n", o.flag.c_str(), o.type.c_str());
+            return false;
+        }
+        if (isParsedType(o.type) && parsedValue(o).isEmpty()) {
+            fprintf(stderr, "Option \"%s\" has an invalid default value\n", o.flag.c_str());
+            return false;
+        }
+        options.emplace_back(o);
+    }
+    return true;
+}
+
+// Generates the C++ initializer of an option's descriptor, zero values are used if the default value is not defined
+static std::string descriptor(const SchemaOption& o)
+{
+    const picojson::value& v = o.defaultValue;
+    const std::string type = (o.type == "BOOLEAN") ? "BOOL" : o.type;
+    char number[64];
+    snprintf(number, sizeof(number), "%.17g", v.is<double>() ? v.get<double>() : ((v.is<bool>() && v.get<bool>()) ? 1.0 : 0.0));
+    return "{ " + quote(o.flag) + ", " + quote(o.shortflag) + ", " + quote(o.description) + 
+        ", miniconf::Value::DataType::" + type + ", " + (o.required ? "true" : "false") + ", " + number + ", " +
+        quote(isParsedType(o.type) ? parsedText(o) : v.is<std::string>() ? v.get<std::string>() : "") + " }";
+}
+
+// Writes the C++ array of a perfect hash
+static void writeHash(FILE* fd, const std::string& name, const PerfectHash& ph)
+{
+    fprintf(fd, "        static const uint32_t %s_DISPLACEMENTS[] = {", name.c_str());
+    for (size_t i = 0; i < ph.displacements.size(); ++i) {
+        fprintf(fd, "%s%uu", (i == 0) ? " " : ", ", ph.displacements[i]);
+    }
+    fprintf(fd, " };\n");
+    fprintf(fd, "        static const int %s_SLOTS[] = {", name.c_str());
+    for (size_t i = 0; i < ph.slots.size(); ++i) {
+        fprintf(fd, "%s%d", (i == 0) ? " " : ", ", ph.slots[i]);
+    }
+    fprintf(fd, " };\n");
+}
+
+// Gets the accessor name of an option, names of the generated code are followed by "_" as keywords are
+static std::string accessorName(const std::string& flag)
+{
+    std::string name = identifier(flag);
+    if (name == "OPTION_COUNT" || name == "detail" || name == "flagTable" || name == "define") {
+        name += "_";
+    }
+    return name;
+}
+
+// Writes the generated header
+static bool writeHeader(const std::string& path, const std::string& ns, const std::string& schemaPath, const std::vector<SchemaOption>& options)
+{
+    // perfect hashes over long and short flags
+    std::vector<std::string> flags, shortflags;
+    std::vector<int> flagIndices, shortflagIndices;
+    std::set<std::string> names;
+    for (size_t i = 0; i < options.size(); ++i) {
+        flags.push_back(options[i].flag);
+        flagIndices.push_back(static_cast<int>(i));
+        if (!options[i].shortflag.empty()) {
+            shortflags.push_back(options[i].shortflag);
+            shortflagIndices.push_back(static_cast<int>(i));
+        }
+        if (!names.insert(accessorName(options[i].flag)).second) {
+            fprintf(stderr, "Option \"%s\" has the same accessor name as another option\n", options[i].flag.c_str());
+            return false;
+        }
+    }
+    if (std::set<std::string>(flags.begin(), flags.end()).size() != flags.size() ||
+            std::set<std::string>(shortflags.begin(), shortflags.end()).size() != shortflags.size()) {
+        fprintf(stderr, "Duplicate flags are found in the schema\n");
+        return false;
+    }
+    PerfectHash flagHash, shortflagHash;
+    if (!buildPerfectHash(flags, flagIndices, flagHash) || !buildPerfectHash(shortflags, shortflagIndices, shortflagHash)) {
+        fprintf(stderr, "Unable to build the perfect hash\n");
+        return false;
+    }
+
+    FILE* fd = fopen(path.c_str(), "wb");
+    if (!fd) {
+        fprintf(stderr, "Unable to write header file \"%s\"\n", path.c_str());
+        return false;
+    }
+    std::string guard = miniconf::tools::includeGuard("MINICONF_SCHEMA", ns);
+
+    fprintf(fd, "/*\n * Generated by miniconf_schemagen from \"%s\", do not edit.\n */\n\n", schemaPath.c_str());
+    fprintf(fd, "#ifndef %s\n#define %s\n\n#include <miniconf.h>\n\n", guard.c_str(), guard.c_str());
+    fprintf(fd, "namespace %s\n{\n\n", ns.c_str());
+    fprintf(fd, "    // Number of options in the schema\n");
+    fprintf(fd, "    static const size_t OPTION_COUNT = %u;\n\n", static_cast<unsigned int>(options.size()));
+
+    // tables
+    fprintf(fd, "    namespace detail\n    {\n");
+    fprintf(fd, "        static const char* const FLAGS[] = {");
+    for (size_t i = 0; i < options.size(); ++i) {
+        fprintf(fd, "%s%s", (i == 0) ? " " : ", ", quote(options[i].flag).c_str());
+    }
+    fprintf(fd, "%s };\n", options.empty() ? " \"\"" : "");
+    fprintf(fd, "        static const char* const SHORTFLAGS[] = {");
+    for (size_t i = 0; i < options.size(); ++i) {
+        fprintf(fd, "%s%s", (i == 0) ? " " : ", ", quote(options[i].shortflag).c_str());
+    }
+    fprintf(fd, "%s };\n", options.empty() ? " \"\"" : "");
+    fprintf(fd, "        struct Descriptor {\n");
+    fprintf(fd, "            const char* flag;\n            const char* shortflag;\n            const char* description;\n");
+    fprintf(fd, "            miniconf::Value::DataType type;\n            bool required;\n            double number;\n            const char* string;\n        };\n");
+    fprintf(fd, "        static const Descriptor OPTIONS[] = {\n");
+    for (size_t i = 0; i < options.size(); ++i) {
+        fprintf(fd, "            %s%s\n", descriptor(options[i]).c_str(), (i + 1 < options.size()) ? "," : "");
+    }
+    if (options.empty()) {
+        fprintf(fd, "            { \"\", \"\", \"\", miniconf::Value::DataType::UNKNOWN, false, 0, \"\" }\n");
+    }
+    fprintf(fd, "        };\n");
+    writeHash(fd, "FLAG", flagHash);
+    writeHash(fd, "SHORTFLAG", shortflagHash);
+    fprintf(fd, "\n");
+    fprintf(fd, "        // Resolves a flag or a short flag to its option index, or -1 if it is not defined\n");
+    fprintf(fd, "        inline int find(const char* flag, size_t length, bool shortflag)\n        {\n");
+    fprintf(fd, "            const size_t n = shortflag ? %u : %u;\n",
+            static_cast<unsigned int>(shortflags.size()), static_cast<unsigned int>(flags.size()));
+    fprintf(fd, "            if (n == 0) {\n                return -1;\n            }\n");
+    fprintf(fd, "            const uint32_t* displacements = shortflag ? SHORTFLAG_DISPLACEMENTS : FLAG_DISPLACEMENTS;\n");
+    fprintf(fd, "            const int* slots = shortflag ? SHORTFLAG_SLOTS : FLAG_SLOTS;\n");
+    fprintf(fd, "            uint32_t bucket = miniconf::Config::FlagTable::hash(flag, length, 0) %% n;\n");
+    fprintf(fd, "            int index = slots[miniconf::Config::FlagTable::hash(flag, length, displacements[bucket]) %% n];\n");
+    fprintf(fd, "            const char* key = shortflag ? SHORTFLAGS[index] : FLAGS[index];\n");
+    fprintf(fd, "            return (strlen(key) == length && memcmp(key, flag, length) == 0) ? index : -1;\n");
+    fprintf(fd, "        }\n    }\n\n");
+
+    // flag table and option definitions
+    fprintf(fd, "    // Flag table of the schema\n");
+    fprintf(fd, "    inline const miniconf::Config::FlagTable& flagTable()\n    {\n");
+    fprintf(fd, "        static const miniconf::Config::FlagTable table = { OPTION_COUNT, detail::FLAGS, &detail::find };\n");
+    fprintf(fd, "        return table;\n    }\n\n");
+    fprintf(fd, "    // Defines the options of the schema and sets its flag table\n");
+    fprintf(fd, "    inline void define(miniconf::Config& conf)\n    {\n");
+    fprintf(fd, "        std::vector<miniconf::Config::Option> options(OPTION_COUNT);\n");
+    fprintf(fd, "        for (size_t i = 0; i < OPTION_COUNT; ++i) {\n");
+    fprintf(fd, "            const detail::Descriptor& d = detail::OPTIONS[i];\n");
+    fprintf(fd, "            options[i].flag(d.flag).shortflag(d.shortflag).required(d.required).description(d.description);\n");
+    fprintf(fd, "            // the default value also determines the data type of a required option\n");
+    fprintf(fd, "            switch (d.type) {\n");
+    fprintf(fd, "                case miniconf::Value::DataType::INT:\n");
+    fprintf(fd, "                    options[i].defaultValue(static_cast<int>(d.number));\n                    break;\n");
+    fprintf(fd, "                case miniconf::Value::DataType::NUMBER:\n");
+    fprintf(fd, "                    options[i].defaultValue(d.number);\n                    break;\n");
+    fprintf(fd, "                case miniconf::Value::DataType::BOOL:\n");
+    fprintf(fd, "                    options[i].defaultValue(d.number != 0.0);\n                    break;\n");
+    fprintf(fd, "                case miniconf::Value::DataType::STRING:\n");
+    fprintf(fd, "                    options[i].defaultValue(d.string);\n                    break;\n");
+    fprintf(fd, "                default:\n");
+    fprintf(fd, "                    options[i].defaultValue(miniconf::Value::parse(d.string, d.type));\n                    break;\n");
+    fprintf(fd, "            }\n        }\n");
+    fprintf(fd, "        conf.options(std::move(options));\n");
+    fprintf(fd, "        conf.flagTable(&flagTable());\n    }\n\n");
+
+    // typed accessors
+    for (auto && o : options) {
+        const char* type = (o.type == "INT") ? "int" : (o.type == "NUMBER") ? "double" : (o.type == "BOOLEAN") ? "bool" : 
+            (o.type == "INT64" || o.type == "DURATION") ? "int64_t" : (o.type == "UINT64" || o.type == "BYTES") ? "uint64_t" : "std::string";
+        const char* getter = (o.type == "INT") ? "getInt" : (o.type == "NUMBER") ? "getNumber" : (o.type == "BOOLEAN") ? "getBoolean" : 
+            (o.type == "INT64") ? "getInt64" : (o.type == "UINT64") ? "getUInt64" : (o.type == "DURATION") ? "getDuration" : 
+            (o.type == "BYTES") ? "getBytes" : "getString";
+        // the description may contain any text, e.g. new lines
+        fprintf(fd, "    %s\n", blockComment(o.description.empty() ? o.flag : o.description, 4).c_str());
+        fprintf(fd, "    inline %s %s(const miniconf::Config& conf)\n    {\n", type, accessorName(o.flag).c_str());
+        fprintf(fd, "        static const std::string flag(%s);\n", quote(o.flag).c_str());
+        fprintf(fd, "        return conf.value(flag).%s();\n    }\n\n", getter);
+    }
+    fprintf(fd, "}\n\n#endif // %s\n", guard.c_str());
+    fclose(fd);
+    return true;
+}
+
+/* Main file */
+int main(int argc, char** argv)
+{
+    miniconf::Config conf;
+    conf.description("Generates a C++ header from a miniconf schema file");
+    conf.option("schema").shortflag("s").defaultValue("").required(true).description("Input schema file (JSON)");
+    conf.option("output").shortflag("o").defaultValue("").required(true).description("Output header file");
+    conf.option("namespace").shortflag("n").defaultValue("schema").required(false).description("Namespace of the generated code");
+    conf.enableConfig(false);
+    conf.log(miniconf::Config::LogLevel::ERROR);
+    if (!conf.parse(argc, argv)) {
+        return 1;
+    }
+    std::string schemaPath = conf.value("schema").getString();
+    std::string outputPath = conf.value("output").getString();
+    if (schemaPath.empty() || outputPath.empty()) {
+        conf.usage(stderr);
+        return 1;
+    }
+    std::string ns = conf.value("namespace").getString();
+    if (!miniconf::tools::isIdentifier(ns)) {
+        fprintf(stderr, "Namespace \"%s\" is not a C++ identifier\n", ns.c_str());
+        return 1;
+    }
+
+    std::vector<SchemaOption> options;
+    if (!readSchema(schemaPath, options)) {
+        return 1;
+    }
+    return writeHeader(outputPath, ns, schemaPath, options) ? 0 : 1;
+}
@@ -0,0 +1,72 @@
+include(CMakeParseArguments)
+
+# miniconf_generate_schema(<target> SCHEMA <schema.json> [OUTPUT <header>] [NAMESPACE <namespace>])
+#
+# Generates a C++ header from a miniconf schema file and adds it to a target.
+# The header is written to the binary directory by default, which is added to
+# the include directories of the target.
+function(miniconf_generate_schema TARGET)
+    cmake_parse_arguments(ARG "" "SCHEMA;OUTPUT;NAMESPACE" "" ${ARGN})
+    if(NOT ARG_SCHEMA)
+        message(FATAL_ERROR "miniconf_generate_schema: SCHEMA is required")
+    endif()
+    get_filename_component(SCHEMA_PATH ${ARG_SCHEMA} ABSOLUTE)
+    get_filename_component(SCHEMA_NAME ${ARG_SCHEMA} NAME_WE)
+    if(NOT ARG_OUTPUT)
+        set(ARG_OUTPUT "${CMAKE_CURRENT_BINARY_DIR}/${SCHEMA_NAME}.h")
+    endif()
+    if(NOT ARG_NAMESPACE)
+        # e.g. "my-settings.json" becomes namespace "my_settings"
+        string(MAKE_C_IDENTIFIER ${SCHEMA_NAME} ARG_NAMESPACE)
+    endif()
+    get_filename_component(OUTPUT_PATH ${ARG_OUTPUT} ABSOLUTE BASE_DIR ${CMAKE_CURRENT_BINARY_DIR})
+    get_filename_component(OUTPUT_DIR ${OUTPUT_PATH} DIRECTORY)
+
+    add_custom_command(
+        OUTPUT ${OUTPUT_PATH}
+        COMMAND miniconf_schemagen --schema ${SCHEMA_PATH} --output ${OUTPUT_PATH} --namespace ${ARG_NAMESPACE}
+        DEPENDS miniconf_schemagen ${SCHEMA_PATH}
+        COMMENT "Generating miniconf schema ${OUTPUT_PATH}"
+        VERBATIM)
+    target_sources(${TARGET} PRIVATE ${OUTPUT_PATH})
+    target_include_directories(${TARGET} PRIVATE ${OUTPUT_DIR})
+endfunction()
+
+# miniconf_freeze_config(<target> CONFIG <config file> [OUTPUT <header>] [NAMESPACE <namespace>] [SCHEMA <schema.json>])
+#
+# Generates a C++ header of constexpr values from a config file (JSON or CSV)
+# and adds it to a target. The header is written to the binary directory by
+# default, which is added to the include directories of the target. The types
+# of the values are declared by the schema file if it is given.
+function(miniconf_freeze_config TARGET)
+    cmake_parse_arguments(ARG "" "CONFIG;OUTPUT;NAMESPACE;SCHEMA" "" ${ARGN})
+    if(NOT ARG_CONFIG)
+        message(FATAL_ERROR "miniconf_freeze_config: CONFIG is required")
+    endif()
+    get_filename_component(CONFIG_PATH ${ARG_CONFIG} ABSOLUTE)
+    get_filename_component(CONFIG_NAME ${ARG_CONFIG} NAME_WE)
+    if(NOT ARG_OUTPUT)
+        set(ARG_OUTPUT "${CMAKE_CURRENT_BINARY_DIR}/${CONFIG_NAME}.h")
+    endif()
+    if(NOT ARG_NAMESPACE)
+        string(MAKE_C_IDENTIFIER ${CONFIG_NAME} ARG_NAMESPACE)
+    endif()
+    get_filename_component(OUTPUT_PATH ${ARG_OUTPUT} ABSOLUTE BASE_DIR ${CMAKE_CURRENT_BINARY_DIR})
+    get_filename_component(OUTPUT_DIR ${OUTPUT_PATH} DIRECTORY)
+
+    set(SCHEMA_ARGS "")
+    set(SCHEMA_PATH "")
+    if(ARG_SCHEMA)
+        get_filename_component(SCHEMA_PATH ${ARG_SCHEMA} ABSOLUTE)
+        set(SCHEMA_ARGS --schema ${SCHEMA_PATH})
+    endif()
+
+    add_custom_command(
+        OUTPUT ${OUTPUT_PATH}
+        COMMAND miniconf_freeze --input ${CONFIG_PATH} --output ${OUTPUT_PATH} --namespace ${ARG_NAMESPACE} ${SCHEMA_ARGS}
+        DEPENDS miniconf_freeze ${CONFIG_PATH} ${SCHEMA_PATH}
+        COMMENT "Freezing miniconf config ${OUTPUT_PATH}"
+        VERBATIM)
+    target_sources(${TARGET} PRIVATE ${OUTPUT_PATH})
+    target_include_directories(${TARGET} PRIVATE ${OUTPUT_DIR})
+endfunction()
@@ -0,0 +1,115 @@
+/*
+ * miniconf_tools.h
+ *
+ * Helper functions shared by the miniconf code generators
+ */
+
+#ifndef __MINICONF_TOOLS_H__
+#define __MINICONF_TOOLS_H__
+
+#include <cstdio>
+#include <cctype>
+#include <string>
+
+namespace miniconf
+{
+    namespace tools
+    {
+        // Quotes a string as a C++ string literal
+        inline std::string quote(const std::string& str)
+        {
+            std::string out = "\"";
+            for (char c : str) {
+                if (c == '"' || c == '\\') {
+                    out += '\\';
+                    out += c;
+                } else if (static_cast<unsigned char>(c) < 0x20) {
+                    char escaped[8];
+                    snprintf(escaped, sizeof(escaped), "\\%03o", static_cast<unsigned char>(c));
+                    out += escaped;
+                } else {
+                    out += c;
+                }
+            }
+            return out + "\"";
+        }
+
+        // Checks if a name is a C++ keyword
+        inline bool isKeyword(const std::string& name)
+        {
+            static const char* const keywords[] = {
+                "alignas", "alignof", "and", "and_eq", "asm", "auto", "bitand", "bitor", "bool", "break",
+                "case", "catch", "char", "char16_t", "char32_t", "class", "compl", "const", "constexpr",
+                "const_cast", "continue", "decltype", "default", "delete", "do", "double", "dynamic_cast",
+                "else", "enum", "explicit", "export", "extern", "false", "float", "for", "friend", "goto",
+                "if", "inline", "int", "long", "mutable", "namespace", "new", "noexcept", "not", "not_eq",
+                "nullptr", "operator", "or", "or_eq", "private", "protected", "public", "register",
+                "reinterpret_cast", "return", "short", "signed", "sizeof", "static", "static_assert",
+                "static_cast", "struct", "switch", "template", "this", "thread_local", "throw", "true",
+                "try", "typedef", "typeid", "typename", "union", "unsigned", "using", "virtual", "void",
+                "volatile", "wchar_t", "while", "xor", "xor_eq"
+            };
+            for (const char* keyword : keywords) {
+                if (name == keyword) {
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        // Converts a name to a C++ identifier, e.g. "part1.value1" to "part1_value1"
+        inline std::string identifier(const std::string& name)
+        {
+            std::string out;
+            for (char c : name) {
+                out += isalnum(static_cast<unsigned char>(c)) ? c : '_';
+            }
+            if (out.empty() || isdigit(static_cast<unsigned char>(out[0]))) {
+                out = "_" + out;
+            }
+            return isKeyword(out) ? out + "_" : out;
+        }
+
+        // Checks if a name can be used as a C++ identifier, e.g. as the name of the generated namespace
+        inline bool isIdentifier(const std::string& name)
+        {
+            if (name.empty() || isdigit(static_cast<unsigned char>(name[0])) || isKeyword(name)) {
+                return false;
+            }
+            for (char c : name) {
+                if (!isalnum(static_cast<unsigned char>(c)) && c != '_') {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        // Converts a name to the name of an include guard
+        inline std::string includeGuard(const std::string& prefix, const std::string& name)
+        {
+            std::string guard = "__" + prefix + "_" + identifier(name) + "_H__";
+            for (auto && c : guard) {
+                c = static_cast<char>(toupper(static_cast<unsigned char>(c)));
+            }
+            return guard;
+        }
+
+        // Formats a text as a C++ block comment, the lines after the first are indented and "*/" is broken up
+        inline std::string blockComment(const std::string& text, int indent)
+        {
+            std::string out = "/* ";
+            for (char c : text) {
+                if (c == '\n') {
+                    out += "\n" + std::string(indent, ' ') + " * ";
+                } else if (c == '/' && out.back() == '*') {
+                    out += " /";
+                } else if (c != '\r') {
+                    out += c;
+                }
+            }
+            return out + " */";
+        }
+    }
+}
+
+#endif // __MINICONF_TOOLS_H__